@@ -3,56 +3,42 @@
 // Khởi tạo con trỏ toàn cục
 LEDController* g_leds = nullptr;
 Buzzer* g_buzzer = nullptr;
-MQ2Sensor* g_mq2 = nullptr;
-FlameSensor* g_flame = nullptr;
 
-// Thời gian debounce Buzzer (ms)
-static unsigned long lastBuzzerTime = 0;
-const unsigned long BUZZER_MIN_INTERVAL = 500; // Buzzer chỉ kích hoạt ≥ 0.5s/lần
+// Loại cảnh báo hiện tại; mẫu chỉ được đổi khi loại cảnh báo thay đổi
+enum AlertLevel : uint8_t { ALERT_NORMAL, ALERT_GAS, ALERT_FLAME, ALERT_UNSET };
+static AlertLevel currentLevel = ALERT_UNSET;
 
-void initAlerts(LEDController* leds, Buzzer* buzzer, MQ2Sensor* mq2, FlameSensor* flame) {
+// Bảng mẫu theo loại cảnh báo (timer tự chạy nhịp, loop() không cần can thiệp)
+struct AlertScene {
+    const AlertPattern* red;
+    const AlertPattern* yellow;
+    const AlertPattern* green;
+    const AlertPattern* buzzer;
+};
+
+static const AlertScene SCENES[] = {
+    /* ALERT_NORMAL */ {&PATTERN_OFF, &PATTERN_OFF, &PATTERN_SOLID, &PATTERN_OFF},
+    /* ALERT_GAS    */ {&PATTERN_OFF, &PATTERN_BLINK, &PATTERN_OFF, &PATTERN_DOUBLE_PULSE},
+    /* ALERT_FLAME  */ {&PATTERN_BLINK_FAST, &PATTERN_OFF, &PATTERN_OFF, &PATTERN_SIREN},
+};
+
+void initAlerts(LEDController* leds, Buzzer* buzzer) {
     g_leds = leds;
     g_buzzer = buzzer;
-    g_mq2 = mq2;
-    g_flame = flame;
 }
 
-void updateAlerts() {
-    if (!g_leds || !g_buzzer || !g_mq2 || !g_flame) return;
-
-    // Kiểm tra trạng thái nguy hiểm
-    bool flame = g_flame->isStableFlame();
-    bool gasDanger = g_mq2->isDanger();
-    bool danger = flame || gasDanger;
-
-    // Điều khiển Buzzer với debounce
-    if (danger) {
-        unsigned long now = millis();
-        if (now - lastBuzzerTime >= BUZZER_MIN_INTERVAL) {
-            g_buzzer->on();
-            lastBuzzerTime = now;
-        }
-    } else {
-        g_buzzer->off();
-    }
-
-    // ---- Điều khiển LED ----
-    if (flame) {
-        g_leds->setRed(true);
-        g_leds->setYellow(false);
-        g_leds->setGreen(false);
-        //Serial.println("ALERT: Flame detected!");
-    } 
-    else if (gasDanger) {
-        g_leds->setRed(false);
-        g_leds->setYellow(true);
-        g_leds->setGreen(false);
-        //Serial.println("ALERT: Gas level high!");
-    } 
-    else {
-        // ✅ Môi trường bình thường → LED xanh sáng ổn định
-        g_leds->setRed(false);
-        g_leds->setYellow(false);
-        g_leds->setGreen(true);
-    }
+// Nhận kết quả loop() đã đánh giá: không đọc lại cảm biến (isDanger() đẩy bộ đếm trễ của MQ2)
+void updateAlerts(bool gasDanger, bool flame) {
+    if (!g_leds || !g_buzzer) return;
+
+    // Lửa ưu tiên hơn gas
+    AlertLevel level = flame ? ALERT_FLAME : (gasDanger ? ALERT_GAS : ALERT_NORMAL);
+    if (level == currentLevel) return;
+    currentLevel = level;
+
+    const AlertScene& scene = SCENES[level];
+    g_leds->playRed(*scene.red);
+    g_leds->playYellow(*scene.yellow);
+    g_leds->playGreen(*scene.green);
+    g_buzzer->play(*scene.buzzer);
 }
@@ -3,19 +3,15 @@
 
 #include "actuators/LEDController.h"
 #include "actuators/Buzzer.h"
-#include "sensors/MQ2Sensor.h"
-#include "sensors/FlameSensor.h"
 
 // Khai báo con trỏ toàn cục
 extern LEDController* g_leds;
 extern Buzzer* g_buzzer;
-extern MQ2Sensor* g_mq2;
-extern FlameSensor* g_flame;
 
-// Khởi tạo Alerts với LED, Buzzer, MQ2 và Flame
-void initAlerts(LEDController* leds, Buzzer* buzzer, MQ2Sensor* mq2, FlameSensor* flame);
+// Khởi tạo Alerts với LED và Buzzer
+void initAlerts(LEDController* leds, Buzzer* buzzer);
 
-// Cập nhật trạng thái LED & Buzzer theo sensor
-void updateAlerts();
+// Cập nhật trạng thái LED & Buzzer theo trạng thái nguy hiểm loop() đã đánh giá
+void updateAlerts(bool gasDanger, bool flame);
 
 #endif
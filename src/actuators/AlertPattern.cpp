@@ -0,0 +1,98 @@
+// AlertPattern.cpp
+#include "AlertPattern.h"
+
+static const PatternStep OFF_STEPS[] = {{false, 0}};
+static const PatternStep SOLID_STEPS[] = {{true, 0}};
+static const PatternStep BLINK_STEPS[] = {{true, 250}, {false, 250}};
+static const PatternStep BLINK_FAST_STEPS[] = {{true, 100}, {false, 100}};
+static const PatternStep DOUBLE_PULSE_STEPS[] = {{true, 100}, {false, 100}, {true, 100}, {false, 700}};
+static const PatternStep SIREN_STEPS[] = {
+  {true, 300}, {false, 150}, {true, 200}, {false, 100}, {true, 120}, {false, 60},
+  {true, 120}, {false, 60}, {true, 200}, {false, 100}};
+
+#define PATTERN(steps) {steps, sizeof(steps) / sizeof(steps[0])}
+const AlertPattern PATTERN_OFF = PATTERN(OFF_STEPS);
+const AlertPattern PATTERN_SOLID = PATTERN(SOLID_STEPS);
+const AlertPattern PATTERN_BLINK = PATTERN(BLINK_STEPS);
+const AlertPattern PATTERN_BLINK_FAST = PATTERN(BLINK_FAST_STEPS);
+const AlertPattern PATTERN_DOUBLE_PULSE = PATTERN(DOUBLE_PULSE_STEPS);
+const AlertPattern PATTERN_SIREN = PATTERN(SIREN_STEPS);
+
+PatternChannel::PatternChannel(uint8_t p, bool low)
+    : pin(p), activeLow(low), level(false), pattern(&PATTERN_OFF), step(0), stepAt(0), generation(0),
+      timer(nullptr), mux(portMUX_INITIALIZER_UNLOCKED) {
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, activeLow ? HIGH : LOW);
+}
+
+void PatternChannel::write(bool on) { digitalWrite(pin, (on != activeLow) ? HIGH : LOW); }
+
+// Gọi trong critical section: chỉ cập nhật trạng thái. esp_timer_* và digitalWrite() không được gọi
+// khi đang giữ spinlock (ngắt bị tắt → có thể deadlock hoặc kích interrupt watchdog)
+PatternChannel::StepAction PatternChannel::startStep(int64_t at) {
+  const PatternStep& s = pattern->steps[step];
+  level = s.on;
+  stepAt = at;
+  if (s.durationMs == 0 || pattern->count == 1) return {s.on, -1}; // mức cố định, không cần timer
+
+  // Hẹn theo mốc tuyệt đối để sai số không cộng dồn qua các chu kỳ
+  int64_t next = at + (int64_t)s.durationMs * 1000;
+  int64_t delay = next - esp_timer_get_time();
+  return {s.on, delay > 0 ? delay : 1};
+}
+
+void PatternChannel::play(const AlertPattern& p) {
+  if (pattern == &p) return;
+
+  if (!timer) { // tạo lười, esp_timer chưa sẵn sàng lúc chạy constructor toàn cục
+    esp_timer_create_args_t args = {};
+    args.callback = &PatternChannel::onTimer;
+    args.arg = this;
+    args.name = "alert";
+    esp_timer_create(&args, &timer);
+  }
+
+  portENTER_CRITICAL(&mux);
+  pattern = &p;
+  step = 0;
+  generation++;
+  StepAction a = startStep(esp_timer_get_time());
+  portEXIT_CRITICAL(&mux);
+
+  esp_timer_stop(timer);
+  write(a.on);
+  if (a.delayUs >= 0 && esp_timer_start_once(timer, a.delayUs) == ESP_ERR_INVALID_STATE) {
+    // Callback của mẫu cũ vừa hẹn lại timer giữa stop và start: hủy rồi hẹn lại cho mẫu mới
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, a.delayUs);
+  }
+}
+
+void PatternChannel::set(bool on) { play(on ? PATTERN_SOLID : PATTERN_OFF); }
+
+void PatternChannel::onTimer(void* arg) { static_cast<PatternChannel*>(arg)->advance(); }
+
+void PatternChannel::advance() {
+  portENTER_CRITICAL(&mux);
+  int64_t next = stepAt + (int64_t)pattern->steps[step].durationMs * 1000;
+  // Callback cũ đã nổ trong lúc play() đổi mẫu → bỏ qua, timer của mẫu mới vẫn chạy
+  if (pattern->steps[step].durationMs == 0 || esp_timer_get_time() + 1000 < next) {
+    portEXIT_CRITICAL(&mux);
+    return;
+  }
+  bool was = level;
+  uint32_t gen = generation;
+  step = (step + 1) % pattern->count;
+  StepAction a = startStep(next);
+  portEXIT_CRITICAL(&mux);
+
+  if (a.on != was) write(a.on); // chỉ ghi khi đổi trạng thái
+  if (a.delayUs >= 0) esp_timer_start_once(timer, a.delayUs); // play() vừa hẹn timer → lỗi, bỏ qua
+
+  // play() đổi mẫu trong lúc ghi ở trên: có thể vừa ghi mức của mẫu cũ → ghi lại mức hiện tại
+  portENTER_CRITICAL(&mux);
+  bool changed = generation != gen;
+  bool now = level;
+  portEXIT_CRITICAL(&mux);
+  if (changed) write(now);
+}
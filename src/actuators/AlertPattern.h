@@ -0,0 +1,59 @@
+// AlertPattern.h
+#ifndef ALERTPATTERN_H
+#define ALERTPATTERN_H
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Một bước của mẫu: mức bật/tắt giữ trong durationMs (0 = giữ mãi)
+struct PatternStep {
+  bool on;
+  uint16_t durationMs;
+};
+
+// Mẫu khai báo sẵn, lặp lại vô hạn
+struct AlertPattern {
+  const PatternStep* steps;
+  uint8_t count;
+};
+
+extern const AlertPattern PATTERN_OFF;
+extern const AlertPattern PATTERN_SOLID;
+extern const AlertPattern PATTERN_BLINK;        // 2 Hz
+extern const AlertPattern PATTERN_BLINK_FAST;   // 5 Hz
+extern const AlertPattern PATTERN_DOUBLE_PULSE; // 2 nháy ngắn rồi nghỉ
+extern const AlertPattern PATTERN_SIREN;        // nhịp nhanh dần rồi chậm lại
+
+// Một chân output chạy theo mẫu bằng esp_timer (timer phần cứng), không phụ thuộc loop().
+// Mỗi lần chuyển bước hẹn giờ đúng thời điểm kế tiếp; chỉ ghi GPIO khi mức thay đổi.
+class PatternChannel {
+  public:
+    PatternChannel(uint8_t pin, bool activeLow = false);
+
+    void play(const AlertPattern& pattern); // gọi lại cùng mẫu → không làm gì
+    void set(bool on);                      // dừng mẫu, đặt mức cố định
+    const AlertPattern* current() const { return pattern; }
+
+  private:
+    // Kết quả tính trong critical section; ghi GPIO và hẹn timer sau khi nhả khóa
+    struct StepAction {
+      bool on;
+      int64_t delayUs; // < 0: mức cố định, không hẹn timer
+    };
+
+    static void onTimer(void* arg);
+    void advance();
+    StepAction startStep(int64_t at);
+    void write(bool on);
+
+    uint8_t pin;
+    bool activeLow;
+    bool level;
+    const AlertPattern* pattern;
+    uint8_t step;
+    int64_t stepAt;                 // thời điểm dự kiến của bước hiện tại (us)
+    uint32_t generation;            // tăng mỗi lần play() đổi mẫu
+    esp_timer_handle_t timer;
+    portMUX_TYPE mux;
+};
+
+#endif
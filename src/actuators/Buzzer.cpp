@@ -1,12 +1,9 @@
 // Buzzer.cpp
 #include "Buzzer.h"
 
-Buzzer::Buzzer(uint8_t p){
-  pin = p;
-  pinMode(pin, OUTPUT);
-  off();
-}
+Buzzer::Buzzer(uint8_t p) : channel(p, true) {}
 
-void Buzzer::on(){ digitalWrite(pin, LOW); }
-void Buzzer::off(){ digitalWrite(pin, HIGH); }
-void Buzzer::blink(bool blinkState){ digitalWrite(pin, blinkState ? LOW : HIGH); }
+void Buzzer::on(){ channel.set(true); }
+void Buzzer::off(){ channel.set(false); }
+void Buzzer::blink(bool blinkState){ channel.set(blinkState); }
+void Buzzer::play(const AlertPattern& pattern){ channel.play(pattern); }
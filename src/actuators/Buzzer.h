@@ -2,6 +2,7 @@
 #ifndef BUZZER_H
 #define BUZZER_H
 #include <Arduino.h>
+#include "AlertPattern.h"
 
 class Buzzer {
   public:
@@ -10,9 +11,10 @@ class Buzzer {
     void on();
     void off();
     void blink(bool blinkState); // nhấp nháy đồng bộ với LED
+    void play(const AlertPattern& pattern); // mẫu kêu chạy bằng timer
 
   private:
-    uint8_t pin;
+    PatternChannel channel; // buzzer kích mức LOW
 };
 
 #endif
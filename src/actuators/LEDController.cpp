@@ -1,17 +1,11 @@
 #include "LEDController.h"
 
-LEDController::LEDController(uint8_t r, uint8_t y, uint8_t g){
-  red = r;
-  yellow = y;
-  green = g;
-  pinMode(red, OUTPUT);
-  pinMode(yellow, OUTPUT);
-  pinMode(green, OUTPUT);
-}
+LEDController::LEDController(uint8_t r, uint8_t y, uint8_t g) : red(r), yellow(y), green(g) {}
 
-void LEDController::setRed(bool state){ digitalWrite(red, state); }
-void LEDController::setYellow(bool state){ digitalWrite(yellow, state); }
-void LEDController::setGreen(bool state){ digitalWrite(green, state); }
+// Các hàm set dừng mẫu đang chạy và chỉ ghi GPIO khi trạng thái đổi
+void LEDController::setRed(bool state){ red.set(state); }
+void LEDController::setYellow(bool state){ yellow.set(state); }
+void LEDController::setGreen(bool state){ green.set(state); }
 void LEDController::setAll(bool state){
   setRed(state);
   setYellow(state);
@@ -19,5 +13,9 @@ void LEDController::setAll(bool state){
 }
 void LEDController::resetAll(){ setAll(false); }  // ← thêm dòng này
 
-void LEDController::blinkRed(bool blinkState){ digitalWrite(red, blinkState ? HIGH : LOW); }
-void LEDController::blinkYellow(bool blinkState){ digitalWrite(yellow, blinkState ? HIGH : LOW); }
+void LEDController::blinkRed(bool blinkState){ red.set(blinkState); }
+void LEDController::blinkYellow(bool blinkState){ yellow.set(blinkState); }
+
+void LEDController::playRed(const AlertPattern& pattern){ red.play(pattern); }
+void LEDController::playYellow(const AlertPattern& pattern){ yellow.play(pattern); }
+void LEDController::playGreen(const AlertPattern& pattern){ green.play(pattern); }
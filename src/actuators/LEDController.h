@@ -2,6 +2,7 @@
 #ifndef LEDCONTROLLER_H
 #define LEDCONTROLLER_H
 #include <Arduino.h>
+#include "AlertPattern.h"
 
 class LEDController {
   public:
@@ -18,8 +19,13 @@ class LEDController {
     void blinkRed(bool blinkState);
     void blinkYellow(bool blinkState);
 
+    // Chạy mẫu bằng timer, nhịp chính xác không phụ thuộc loop()
+    void playRed(const AlertPattern& pattern);
+    void playYellow(const AlertPattern& pattern);
+    void playGreen(const AlertPattern& pattern);
+
   private:
-    uint8_t red, yellow, green;
+    PatternChannel red, yellow, green;
 };
 
 #endif
@@ -4,29 +4,37 @@
 #include <WiFiClientSecure.h>
 #include <PubSubClient.h>
 #include "time.h"
-#include <ArduinoJson.h>
+#include <esp_sntp.h>
+#include "telemetry/TimeBase.h"
+#include "telemetry/TelemetryQueue.h"
+#include "telemetry/TelemetryPublisher.h"
+#include "ota_update.h"
+#include "history.h"
+#include "logging/Logger.h"
 
 static unsigned long lastPublishTime = 0;
 const unsigned long PUBLISH_INTERVAL = 1000; // 1s
 
 // ================== HÀM ĐỒNG BỘ THỜI GIAN ==================
-static void syncTimeIfNeeded() {
-    time_t now = time(nullptr);
-    if (now < 100000) {
-        Serial.println("Syncing time with NTP...");
+#define SNTP_SYNC_INTERVAL_MS (10UL * 60 * 1000) // hiệu chỉnh offset/drift mỗi 10 phút
+
+static bool sntpStarted = false;
+
+// Chạy trong task lwIP: chỉ ghi lại mẫu, TimeBase xử lý trong loop()
+static void onTimeSync(struct timeval* tv) {
+    timeBaseOnSync((int64_t)tv->tv_sec * 1000000 + tv->tv_usec, monotonicUs());
+}
+
+// SNTP chạy nền, không chờ. Trả về true khi đồng hồ đã hợp lệ cho TLS handshake.
+static bool syncTimeIfNeeded() {
+    if (!sntpStarted) {
+        LOG_I("Starting background SNTP...");
+        sntp_set_time_sync_notification_cb(onTimeSync);
+        sntp_set_sync_interval(SNTP_SYNC_INTERVAL_MS);
         configTime(7 * 3600, 0, "pool.ntp.org", "time.nist.gov");
-        int retry = 0;
-        while (time(nullptr) < 100000 && retry < 20) {
-            delay(500);
-            Serial.print(".");
-            retry++;
-        }
-        Serial.println();
-        if (time(nullptr) > 100000)
-            Serial.println("✅ Time synced successfully!");
-        else
-            Serial.println("⚠️ Time sync failed, TLS may not work.");
+        sntpStarted = true;
     }
+    return time(nullptr) > 100000;
 }
 // ------------------ KHAI BÁO TOÀN CỤC ------------------
 static WiFiClientSecure net;
@@ -39,46 +47,29 @@ static const unsigned long CONNECT_RETRY_MS = 500; // retry MQTT nhanh
 static bool wifiConnecting = false;
 
 // ------------------ BUFFER DỮ LIỆU ------------------
-struct SensorData {
-    float temp;
-    float hum;
-    int gas;
-    bool flame;
-    bool danger;
-};
-
-#define DATA_QUEUE_SIZE 10
-static SensorData dataQueue[DATA_QUEUE_SIZE];
-static int queueStart = 0;
-static int queueEnd = 0;
+// Queue thường + làn ưu tiên alarm, xem telemetry/TelemetryQueue.h
+static TelemetryQueue txQueue;
 
-// ------------------ HÀM XỬ LÝ QUEUE ------------------
-bool queuePush(const SensorData& data) {
-    int next = (queueEnd + 1) % DATA_QUEUE_SIZE;
-    if (next == queueStart) return false; // full
-    dataQueue[queueEnd] = data;
-    queueEnd = next;
-    return true;
-}
+// Thống kê độ trễ alarm → publish (micro giây)
+static unsigned long lastAlarmLatencyUs = 0;
+static unsigned long maxAlarmLatencyUs = 0;
 
-bool queuePop(SensorData &data) {
-    if (queueStart == queueEnd) return false; // empty
-    data = dataQueue[queueStart];
-    queueStart = (queueStart + 1) % DATA_QUEUE_SIZE;
-    return true;
-}
+// ------------------ HÀM XỬ LÝ QUEUE ------------------
+bool queuePush(const SensorData& data) { return txQueue.push(data); }
+bool queuePop(SensorData &data) { return txQueue.pop(data); }
 
 // ------------------ CALLBACK NHẬN DỮ LIỆU TỪ AWS ------------------
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    Serial.print("\n[AWS] Message arrived on topic: ");
-    Serial.println(topic);
+    LOG_I("\n[AWS] Message arrived on topic: %s", topic);
+
+    if (handleOTACommand(payload, length)) return; // lệnh cập nhật firmware
+    if (handleHistoryCommand(payload, length)) return; // truy vấn lịch sử
 
     String message;
     for (unsigned int i = 0; i < length; i++) {
         message += (char)payload[i];
     }
-    Serial.print("Payload: ");
-    Serial.println(message);
+    LOG_I("Payload: %s", message);
 
     // TODO: xử lý message nếu muốn điều khiển thiết bị
 }
@@ -87,7 +78,7 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
 void connectAWS() {
     // Step 1: Kiểm tra Wi-Fi
 if (WiFi.status() != WL_CONNECTED) {
-    Serial.print(".");
+    LOG_D("WiFi connecting...");
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
     delay(1000);
     return;
@@ -95,27 +86,29 @@ if (WiFi.status() != WL_CONNECTED) {
 
 
     // Step 2: MQTT connect
+    // ✅ TLS cần giờ đúng: chưa sync xong thì bỏ qua lượt này, không chặn loop
+    if (!syncTimeIfNeeded()) return;
+
     if (!client.connected() && millis() - lastConnectAttempt >= CONNECT_RETRY_MS) {
         net.stop();  // reset TLS socket để tránh session stale
-        syncTimeIfNeeded(); // ✅ đảm bảo đồng bộ thời gian trước khi TLS handshake
         net.setCACert(AWS_CERT_CA);
         net.setCertificate(AWS_CERT_CRT);
         net.setPrivateKey(AWS_CERT_PRIVATE);
         client.setServer(AWS_IOT_ENDPOINT, 8883);
         client.setCallback(mqttCallback);
+        client.setBufferSize(1100); // lệnh OTA, block lịch sử base64, lô gateway (1 KB + header)
 
         String clientId = String(AWS_IOT_CLIENT_ID);
-        Serial.print("Connecting to AWS IoT...");
+        LOG_I("Connecting to AWS IoT...");
         if (client.connect(clientId.c_str())) {
             awsConnected = true;
-            Serial.println(" connected ✅");
-            #ifdef AWS_IOT_SUB_TOPIC
-            client.subscribe(AWS_IOT_SUB_TOPIC);
+            LOG_I("AWS IoT connected ✅");
+            #ifdef AWS_IOT_SUBSCRIBE_TOPIC
+            client.subscribe(AWS_IOT_SUBSCRIBE_TOPIC);
             #endif
         } else {
             awsConnected = false;
-            Serial.print(" failed, state=");
-            Serial.println(client.state());
+            LOG_W("AWS IoT connect failed, state=%d", client.state());
         }
         lastConnectAttempt = millis();
     }
@@ -125,57 +118,90 @@ if (WiFi.status() != WL_CONNECTED) {
 }
 
 
-// ------------------ GỬI DỮ LIỆU LÊN AWS (QUEUE) ------------------
-void publishQueue() {
-    if (!client.connected()) return;
-
-    unsigned long now = millis();
-    if (now - lastPublishTime < PUBLISH_INTERVAL) return;
-
-    SensorData data;
-    if (!queuePop(data)) return;
-
-    StaticJsonDocument<300> doc;
-
-    doc["deviceId"] = "ESP32_01";
-    doc["timestamp"] = time(nullptr);
-
-    //  Dùng số thật, không dùng String()
-    doc["temperature"] = data.temp;
-    doc["humidity"]    = data.hum;
-    doc["gas"]         = data.gas;
-
-    JsonObject alert = doc.createNestedObject("alert");
-    alert["flame"]  = data.flame ? 1 : 0;
-    alert["danger"] = data.danger ? 1 : 0;
+// ------------------ GỬI MỘT BẢN GHI ------------------
+// Thứ tự xả queue (alarm trước, không throttle; dữ liệu thường theo PUBLISH_INTERVAL) nằm trong
+// telemetry/TelemetryPublisher, dùng chung với tools/fleet_sim.
+static bool publishRecord(const SensorData& data, void* ctx) {
+    (void)ctx;
+    if (!client.connected()) return false;
 
     char payload[300];
-    serializeJson(doc, payload);
+    serializeSensorData(data, AWS_IOT_CLIENT_ID, payload, sizeof(payload));
+    bool alarm = data.priority == PRIORITY_ALARM;
 
-    if (client.publish(AWS_IOT_PUBLISH_TOPIC, payload)) {
-        Serial.println("[AWS] Published:");
-        Serial.println(payload);
+    if (!client.publish(AWS_IOT_PUBLISH_TOPIC, payload)) {
+        if (alarm) LOG_W("[AWS] Alarm publish failed → retry later");
+        else LOG_W("[AWS] Publish failed → retry later");
+        return false;
+    }
+
+    if (alarm) {
+        lastAlarmLatencyUs = monotonicUs() - data.capturedUs;
+        if (lastAlarmLatencyUs > maxAlarmLatencyUs) maxAlarmLatencyUs = lastAlarmLatencyUs;
+        LOG_I("[AWS] Alarm published, latency=%lu us (max=%lu us)",
+              lastAlarmLatencyUs, maxAlarmLatencyUs);
     } else {
-        Serial.println("[AWS] Publish failed → retry later");
-        queuePush(data);
+        LOG_I("[AWS] Published: %s", payload);
     }
+    return true;
+}
 
-    lastPublishTime = now;
+// ------------------ GỬI DỮ LIỆU LÊN AWS (QUEUE) ------------------
+void publishQueue() {
+    if (!client.connected()) return;
+    publishTelemetry(txQueue, millis(), lastPublishTime, PUBLISH_INTERVAL, publishRecord, nullptr);
 }
 
 
 
 // ------------------ HÀM CHÍNH GỌI TRONG LOOP ------------------
 void loopAWS() {
+    timeBaseLoop();
     connectAWS();
     publishQueue();
 }
 
 // ------------------ GỬI DỮ LIỆU MỚI VÀO QUEUE ------------------
 
-void sendSensorData(float temp, float hum, int gas, bool flame, bool danger) {
-    SensorData data = {temp, hum, gas, flame, danger};
+void sendSensorData(float temp, float hum, int gas, bool flame, bool danger, DataPriority priority) {
+    SensorData data = {temp, hum, gas, flame, danger, priority, monotonicUs()};
+
+    if (priority == PRIORITY_ALARM) {
+        unsigned long overwrites = txQueue.getAlarmOverwrites();
+        txQueue.pushAlarm(data);
+        if (txQueue.getAlarmOverwrites() != overwrites) {
+            LOG_W("Alarm queue full, overwrote oldest (%lu total)", txQueue.getAlarmOverwrites());
+        }
+        publishAlarmLane(txQueue, publishRecord, nullptr); // gửi ngay nếu đang kết nối, không chờ vòng loop sau
+        return;
+    }
+
     if (!queuePush(data)) {
-        Serial.println("Queue full, dropping data!");
+        LOG_W("Queue full, dropping data!");
     }
 }
+
+bool isAWSConnected() { return client.connected(); }
+
+bool publishSensorRecord(const SensorData& data) {
+    if (!client.connected()) return false;
+
+    char payload[300];
+    serializeSensorData(data, AWS_IOT_CLIENT_ID, payload, sizeof(payload));
+    return client.publish(AWS_IOT_PUBLISH_TOPIC, payload);
+}
+
+int pendingTelemetry() { return txQueue.size() + txQueue.alarmSize(); }
+
+void disconnectAWS() {
+    if (client.connected()) client.disconnect();
+    net.stop();
+    awsConnected = false;
+}
+
+bool publishMessage(const char* topic, const char* payload) {
+    return client.connected() && client.publish(topic, payload);
+}
+
+unsigned long getLastAlarmLatencyUs() { return lastAlarmLatencyUs; }
+unsigned long getMaxAlarmLatencyUs() { return maxAlarmLatencyUs; }
@@ -2,9 +2,22 @@
 #define AWS_MQTT_H
 
 #include <Arduino.h>
+#include "telemetry/SensorData.h"
 
 void connectAWS(); // non-blocking connect attempt (returns quickly or handles internal reconnect)
 void loopAWS();    // must be called frequently from loop()
-void sendSensorData(float temp, float hum, int gas, bool flame, bool danger);
+bool isAWSConnected();
+bool publishMessage(const char* topic, const char* payload); // false nếu chưa kết nối/lỗi gửi
+void sendSensorData(float temp, float hum, int gas, bool flame, bool danger,
+                    DataPriority priority = PRIORITY_ROUTINE);
+
+// Chế độ pin (low_power.h): gửi ngay một bản ghi đã có capturedUs, không qua queue
+bool publishSensorRecord(const SensorData& data);
+int pendingTelemetry(); // số bản ghi còn trong queue + làn alarm
+void disconnectAWS();   // ngắt MQTT/TLS gọn gàng trước khi tắt WiFi
+
+// Độ trễ từ lúc phát hiện nguy hiểm đến khi publish xong (micro giây)
+unsigned long getLastAlarmLatencyUs();
+unsigned long getMaxAlarmLatencyUs();
 
 #endif
@@ -83,3 +83,43 @@ void OLEDDisplay::updateData(float temp, float hum, int gas, bool gasDanger, boo
     lastGasDanger = gasDanger;
     lastFireDanger = fireDanger;
 }
+
+void OLEDDisplay::showTrend(const char* label, const char* unit, const float* values, uint8_t count) {
+    display.setDrawColor(1);
+    display.clearBuffer();
+    display.setFont(u8g2_font_6x12_tf);
+
+    if (count > 128) {
+        values += count - 128;
+        count = 128;
+    }
+
+    float lo = values[0], hi = values[0];
+    for (uint8_t i = 1; i < count; i++) {
+        if (values[i] < lo) lo = values[i];
+        if (values[i] > hi) hi = values[i];
+    }
+
+    // Dòng tiêu đề: tên kênh, giá trị mới nhất, min/max
+    display.setCursor(0, 10);
+    display.printf("%s %.1f%s", label, values[count - 1], unit);
+    display.setCursor(80, 10);
+    display.printf("%dh", (count + 59) / 60);
+    display.setCursor(0, 63);
+    display.printf("%.1f-%.1f", lo, hi);
+
+    // Vùng biểu đồ: y 14..52, căn phải để điểm mới nhất ở mép phải
+    const int top = 14, bottom = 52;
+    float span = hi - lo;
+    if (span < 0.5f) span = 0.5f; // tín hiệu phẳng không bị phóng to thành nhiễu
+    int x0 = 128 - count;
+    int prevY = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        int y = bottom - (int)((values[i] - lo) / span * (bottom - top) + 0.5f);
+        if (i > 0) display.drawLine(x0 + i - 1, prevY, x0 + i, y);
+        else display.drawPixel(x0, y);
+        prevY = y;
+    }
+
+    display.sendBuffer();
+}
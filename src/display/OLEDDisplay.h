@@ -8,6 +8,8 @@ public:
     OLEDDisplay();
     void begin();
     void updateData(float temp, float hum, int gas, bool gasDanger, bool fireDanger);
+    // Trang biểu đồ: values cũ → mới, tối đa 128 điểm (1 điểm/cột)
+    void showTrend(const char* label, const char* unit, const float* values, uint8_t count);
 
 private:
     U8G2_SSD1306_128X64_NONAME_F_HW_I2C display;
@@ -0,0 +1,67 @@
+#include "EspNowTransport.h"
+#include <WiFi.h>
+#include <esp_now.h>
+
+static const uint8_t BROADCAST_ADDR[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static EspNowTransport* instance = nullptr; // callback của esp_now không có tham số ngữ cảnh
+
+EspNowTransport::EspNowTransport()
+    : head(0), count(0), overflows(0), mux(portMUX_INITIALIZER_UNLOCKED) {}
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+static void onEspNowRecv(const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+    if (instance) instance->onReceive(info->src_addr, data, len);
+}
+#else
+static void onEspNowRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    if (instance) instance->onReceive(mac, data, len);
+}
+#endif
+
+bool EspNowTransport::begin() {
+    // Gọi sau WiFi.mode(WIFI_STA); kênh là kênh hiện tại của WiFi
+    if (esp_now_init() != ESP_OK) return false;
+
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, BROADCAST_ADDR, 6);
+    peer.channel = 0;
+    peer.encrypt = false;
+    if (!esp_now_is_peer_exist(BROADCAST_ADDR) && esp_now_add_peer(&peer) != ESP_OK) return false;
+
+    instance = this;
+    return esp_now_register_recv_cb(onEspNowRecv) == ESP_OK;
+}
+
+bool EspNowTransport::send(const uint8_t* data, size_t len) {
+    if (len > LINK_MAX_FRAME) return false;
+    return esp_now_send(BROADCAST_ADDR, data, len) == ESP_OK;
+}
+
+// Task WiFi: chỉ chép frame, đầy thì bỏ frame mới và đếm
+void EspNowTransport::onReceive(const uint8_t* mac, const uint8_t* data, int len) {
+    if (len <= 0 || len > LINK_MAX_FRAME) return;
+
+    portENTER_CRITICAL(&mux);
+    if (count >= ESPNOW_RX_QUEUE) {
+        overflows++;
+    } else {
+        LinkFrame& f = queue[(head + count) % ESPNOW_RX_QUEUE];
+        memcpy(f.src, mac, 6);
+        f.len = len;
+        memcpy(f.data, data, len);
+        count++;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+bool EspNowTransport::receive(LinkFrame& frame) {
+    portENTER_CRITICAL(&mux);
+    bool ok = count > 0;
+    if (ok) {
+        frame = queue[head];
+        head = (head + 1) % ESPNOW_RX_QUEUE;
+        count--;
+    }
+    portEXIT_CRITICAL(&mux);
+    return ok;
+}
@@ -0,0 +1,32 @@
+#ifndef ESPNOWTRANSPORT_H
+#define ESPNOWTRANSPORT_H
+
+#include <Arduino.h>
+#include "LinkTransport.h"
+
+#define ESPNOW_RX_QUEUE 16 // frame chờ loop() xử lý
+
+// ESP-NOW: leaf gửi broadcast (không cần ghép cặp), gateway lọc theo magic của frame.
+// Callback nhận chạy trong task WiFi → chép vào hàng đợi, loop() lấy ra bằng receive().
+// Leaf và gateway phải cùng kênh WiFi (gateway theo kênh của router).
+class EspNowTransport : public LinkTransport {
+  public:
+    EspNowTransport();
+
+    bool begin() override;
+    bool send(const uint8_t* data, size_t len) override;
+    bool receive(LinkFrame& frame) override;
+
+    unsigned long getOverflows() const { return overflows; }
+
+    void onReceive(const uint8_t* mac, const uint8_t* data, int len); // gọi từ callback ESP-NOW
+
+  private:
+    LinkFrame queue[ESPNOW_RX_QUEUE];
+    uint8_t head;
+    uint8_t count;
+    unsigned long overflows;
+    portMUX_TYPE mux;
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "Gateway.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "telemetry/TimeBase.h"
+
+// Document dùng chung, tránh ~2 KB trên stack của loop()
+static StaticJsonDocument<2048> batchDoc;
+
+Gateway::Gateway(LinkTransport& l, const char* id, GatewayUplink fn, void* ctx)
+    : link(l), gatewayId(id), uplink(fn), uplinkCtx(ctx), nodesUsed(0), allowedCount(0), batchCount(0),
+      batchStartUs(0), alarmHead(0), alarmCount(0) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+GatewayNode* Gateway::findNode(uint32_t id) {
+    for (uint16_t i = 0; i < nodesUsed; i++) {
+        if (nodes[i].id == id) return &nodes[i];
+    }
+    if (nodesUsed >= GATEWAY_MAX_NODES) return nullptr;
+
+    GatewayNode& n = nodes[nodesUsed++];
+    memset(&n, 0, sizeof(n));
+    n.id = id;
+    return &n;
+}
+
+bool Gateway::allowLeaf(const uint8_t addr[6]) {
+    if (isAllowed(addr)) return true;
+    if (allowedCount >= GATEWAY_MAX_NODES) return false;
+    memcpy(allowed[allowedCount++], addr, 6);
+    return true;
+}
+
+bool Gateway::isAllowed(const uint8_t addr[6]) const {
+    for (uint16_t i = 0; i < allowedCount; i++) {
+        if (memcmp(allowed[i], addr, 6) == 0) return true;
+    }
+    return false;
+}
+
+// ------------------ NHẬN ------------------
+bool Gateway::ingest(const uint8_t* data, size_t len, const uint8_t src[6]) {
+    uint64_t nowUs = monotonicUs();
+    NodeFrame frame;
+    if (!decodeNodeFrame(data, len, nowUs, frame)) {
+        counters.invalid++;
+        return false;
+    }
+    if (!isAllowed(src) || frame.nodeId != nodeIdFromAddress(src)) {
+        counters.rejected++;
+        return false;
+    }
+
+    GatewayNode* node = findNode(frame.nodeId);
+    if (!node) {
+        counters.unknownNodes++;
+        return false;
+    }
+
+    if (node->frames > 0 && frame.boot != node->bootId) {
+        node->reboots++; // leaf vừa khởi động lại: seq cũ không còn ý nghĩa, không tính mất/trùng
+        counters.reboots++;
+    } else if (node->frames > 0) {
+        int16_t diff = (int16_t)(frame.seq - node->lastSeq);
+        if (diff <= 0 && diff > -GATEWAY_SEQ_WINDOW) { // alarm gửi lặp hoặc frame đến muộn
+            node->duplicates++;
+            counters.duplicates++;
+            return false;
+        }
+        if (diff > 1) {
+            node->lost += diff - 1;
+            counters.lost += diff - 1;
+        }
+    }
+    node->lastSeq = frame.seq;
+    node->bootId = frame.boot;
+    node->lastSeenMs = millis();
+    node->frames++;
+    counters.frames++;
+
+    Record* r;
+    if (frame.data.priority == PRIORITY_ALARM) {
+        counters.alarms++;
+        // Làn alarm đầy (uplink mất lâu): bỏ alarm cũ nhất, giữ trạng thái mới nhất
+        if (alarmCount >= GATEWAY_ALARM_MAX) {
+            alarmHead = (alarmHead + 1) % GATEWAY_ALARM_MAX;
+            alarmCount--;
+            counters.droppedAlarms++;
+        }
+        r = &alarmAt(alarmCount++);
+    } else {
+        // Lô đầy: gửi ngay (alarm đi trước nên có thể vẫn đầy); uplink lỗi thì bỏ routine cũ nhất
+        if (batchCount >= GATEWAY_BATCH_MAX) flush();
+        if (batchCount >= GATEWAY_BATCH_MAX) {
+            memmove(&batch[0], &batch[1], sizeof(Record) * (GATEWAY_BATCH_MAX - 1));
+            batchCount--;
+            counters.dropped++;
+        }
+        if (batchCount == 0) batchStartUs = nowUs;
+        r = &batch[batchCount++];
+    }
+    r->nodeId = frame.nodeId;
+    r->seq = frame.seq;
+    r->data = frame.data;
+    return true;
+}
+
+void Gateway::loop() {
+    LinkFrame frame;
+    for (int i = 0; i < GATEWAY_FRAMES_PER_LOOP && link.receive(frame); i++) {
+        ingest(frame.data, frame.len, frame.src);
+    }
+
+    if (alarmCount > 0 || batchCount >= GATEWAY_BATCH_MAX ||
+        (batchCount > 0 && monotonicUs() - batchStartUs >= (uint64_t)GATEWAY_FLUSH_MS * 1000)) {
+        flush();
+    }
+}
+
+// ------------------ GỬI LÔ ------------------
+// {"gatewayId":"ESP32_01","nodes":[{"deviceId":"00a1b2c3","seq":12,"timestampMs":...,
+//   "temperature":28.4,"humidity":61.2,"gas":412,"alert":{"flame":0,"danger":0},"priority":"routine"}]}
+// Tối đa limit bản ghi: alarm (cũ nhất trước) rồi mới đến routine. 0 nếu không vừa payload
+size_t Gateway::serializeBatch(uint8_t limit, uint8_t& nAlarms, uint8_t& nRoutine) {
+    nAlarms = alarmCount < limit ? alarmCount : limit;
+    nRoutine = batchCount < limit - nAlarms ? batchCount : limit - nAlarms;
+
+    batchDoc.clear();
+    batchDoc["gatewayId"] = gatewayId;
+    if (!timeBaseValid()) batchDoc["synced"] = false; // timestampMs của cả lô tính theo đồng hồ gateway
+    JsonArray list = batchDoc.createNestedArray("nodes");
+
+    for (uint8_t i = 0; i < nAlarms + nRoutine; i++) {
+        const Record& r = i < nAlarms ? alarmAt(i) : batch[i - nAlarms];
+        char id[9];
+        snprintf(id, sizeof(id), "%08lx", (unsigned long)r.nodeId);
+
+        JsonObject o = list.createNestedObject();
+        o["deviceId"] = id; // mảng char → ArduinoJson chép nội dung
+        o["seq"] = r.seq;
+        o["timestampMs"] = toEpochMs(r.data.capturedUs);
+        o["temperature"] = r.data.temp;
+        o["humidity"] = r.data.hum;
+        o["gas"] = r.data.gas;
+        JsonObject alert = o.createNestedObject("alert");
+        alert["flame"] = r.data.flame ? 1 : 0;
+        alert["danger"] = r.data.danger ? 1 : 0;
+        o["priority"] = r.data.priority == PRIORITY_ALARM ? "alarm" : "routine";
+    }
+
+    if (measureJson(batchDoc) >= sizeof(payload)) return 0;
+    return serializeJson(batchDoc, payload, sizeof(payload));
+}
+
+// Bỏ bản ghi đầu hàng đợi (alarm trước): chính nó không vừa payload, giữ lại thì kẹt mãi
+void Gateway::dropFront() {
+    counters.oversized++;
+    if (alarmCount > 0) {
+        alarmHead = (alarmHead + 1) % GATEWAY_ALARM_MAX;
+        alarmCount--;
+        counters.droppedAlarms++;
+    } else {
+        memmove(&batch[0], &batch[1], sizeof(Record) * (batchCount - 1));
+        batchCount--;
+        counters.dropped++;
+    }
+}
+
+// Gửi một lô; còn alarm tồn (sau lúc mất uplink) thì loop() gửi tiếp các lô sau
+bool Gateway::flush() {
+    uint8_t nAlarms = 0, nRoutine = 0;
+    size_t len = 0;
+    uint8_t limit = GATEWAY_BATCH_MAX;
+    // Lô không vừa GATEWAY_PAYLOAD_SIZE: chia đôi; một bản ghi cũng không vừa thì bỏ nó
+    while (batchCount > 0 || alarmCount > 0) {
+        len = serializeBatch(limit, nAlarms, nRoutine);
+        if (len > 0) break;
+        if (limit > 1) limit /= 2;
+        else dropFront();
+    }
+    if (len == 0) return true; // không còn gì (kể cả sau khi bỏ bản ghi quá lớn)
+
+    if (!uplink(payload, len, uplinkCtx)) {
+        counters.uplinkFailures++;
+        return false;
+    }
+
+    uint64_t nowUs = monotonicUs();
+    for (uint8_t i = 0; i < nAlarms + nRoutine; i++) {
+        const Record& r = i < nAlarms ? alarmAt(i) : batch[i - nAlarms];
+        uint64_t latency = nowUs - r.data.capturedUs;
+        counters.latencySumUs += latency;
+        if (latency > counters.latencyMaxUs) counters.latencyMaxUs = (uint32_t)latency;
+    }
+    counters.records += nAlarms + nRoutine;
+    counters.alarmsSent += nAlarms;
+    counters.batches++;
+    counters.uplinkBytes += len;
+
+    alarmHead = (alarmHead + nAlarms) % GATEWAY_ALARM_MAX;
+    alarmCount -= nAlarms;
+    memmove(&batch[0], &batch[nRoutine], sizeof(Record) * (batchCount - nRoutine));
+    batchCount -= nRoutine;
+    if (batchCount > 0) batchStartUs = nowUs; // phần routine còn lại chờ thêm một chu kỳ
+    return true;
+}
@@ -0,0 +1,112 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include "LinkTransport.h"
+#include "NodeFrame.h"
+
+#ifndef GATEWAY_MAX_NODES
+#define GATEWAY_MAX_NODES 16
+#endif
+#define GATEWAY_BATCH_MAX 5          // bản ghi/lô, vừa buffer MQTT của gateway
+#define GATEWAY_ALARM_MAX 32         // làn alarm riêng: giữ alarm của mọi leaf qua lúc mất uplink
+#ifndef GATEWAY_PAYLOAD_SIZE
+#define GATEWAY_PAYLOAD_SIZE 1024     // ≤ buffer MQTT (1100) trừ header
+#endif
+#define GATEWAY_FLUSH_MS 1000        // lô chưa đầy vẫn gửi sau thời gian này
+#define GATEWAY_FRAMES_PER_LOOP 32   // giới hạn việc mỗi lượt loop()
+#define GATEWAY_SEQ_WINDOW 64        // seq lùi trong cửa sổ này = bản trùng (frame đến muộn/gửi lặp)
+
+struct GatewayNode {
+    uint32_t id;
+    uint16_t lastSeq;
+    uint8_t bootId;       // boot của leaf ở frame gần nhất
+    unsigned long lastSeenMs;
+    unsigned long frames;
+    unsigned long duplicates;
+    unsigned long lost;   // khoảng trống seq (frame mất trên đường truyền)
+    unsigned long reboots;
+};
+
+struct GatewayStats {
+    unsigned long frames;        // frame hợp lệ, không trùng
+    unsigned long invalid;
+    unsigned long rejected;      // địa chỉ nguồn chưa đăng ký, hoặc node ID không khớp địa chỉ nguồn
+    unsigned long duplicates;
+    unsigned long lost;
+    unsigned long reboots;       // leaf khởi động lại (boot đổi), seq đếm lại từ đầu
+    unsigned long unknownNodes;  // bảng node đầy
+    unsigned long records;       // bản ghi đã gửi lên
+    unsigned long batches;
+    unsigned long uplinkBytes;
+    unsigned long uplinkFailures;
+    unsigned long dropped;       // bỏ bản ghi routine cũ khi lô đầy mà uplink lỗi
+    unsigned long droppedAlarms; // làn alarm đầy khi mất uplink → bỏ alarm cũ nhất
+    unsigned long oversized;     // một bản ghi riêng lẻ không vừa GATEWAY_PAYLOAD_SIZE → bỏ
+    unsigned long alarms;        // bản ghi alarm đã nhận (không trùng)
+    unsigned long alarmsSent;    // bản ghi alarm đã gửi lên
+    uint64_t latencySumUs;       // đo → gửi lên thành công
+    uint32_t latencyMaxUs;
+};
+
+// Gửi một lô lên cloud; false = chưa gửi được, gateway giữ lô và thử lại
+typedef bool (*GatewayUplink)(const char* payload, size_t len, void* ctx);
+
+// Gateway: nhận SensorData từ các leaf, bỏ bản trùng, gom thành lô JSON gắn node ID.
+// Lô được gửi khi đủ GATEWAY_BATCH_MAX, quá GATEWAY_FLUSH_MS, hoặc ngay khi có alarm.
+// Alarm nằm ở làn riêng và luôn được xếp vào lô trước routine; khi uplink lỗi chỉ routine bị bỏ
+// để nhường chỗ, alarm chỉ mất khi chính làn alarm tràn (giống TelemetryQueue).
+// Frame broadcast không mã hóa: chỉ nhận từ địa chỉ leaf đã đăng ký bằng allowLeaf(), và node ID
+// phải khớp địa chỉ nguồn, để thiết bị lạ trong vùng phủ không giả được alarm/dữ liệu.
+class Gateway {
+  public:
+    Gateway(LinkTransport& link, const char* gatewayId, GatewayUplink uplink, void* ctx = nullptr);
+
+    bool begin() { return link.begin(); }
+    void loop();
+
+    bool allowLeaf(const uint8_t addr[6]); // đăng ký leaf (MAC); chưa đăng ký leaf nào → từ chối mọi frame
+    bool ingest(const uint8_t* data, size_t len, const uint8_t src[6]); // frame thô, true nếu vào lô
+    bool flush();
+
+    const GatewayStats& stats() const { return counters; }
+    uint16_t nodeCount() const { return nodesUsed; }
+    const GatewayNode& node(uint16_t i) const { return nodes[i]; }
+    uint8_t pending() const { return batchCount + alarmCount; }
+
+  private:
+    struct Record {
+        uint32_t nodeId;
+        uint16_t seq;
+        SensorData data;
+    };
+
+    GatewayNode* findNode(uint32_t id);
+    bool isAllowed(const uint8_t addr[6]) const;
+    Record& alarmAt(uint8_t i) { return alarms[(alarmHead + i) % GATEWAY_ALARM_MAX]; }
+    size_t serializeBatch(uint8_t limit, uint8_t& nAlarms, uint8_t& nRoutine);
+    void dropFront();
+
+    LinkTransport& link;
+    const char* gatewayId;
+    GatewayUplink uplink;
+    void* uplinkCtx;
+
+    GatewayNode nodes[GATEWAY_MAX_NODES];
+    uint16_t nodesUsed;
+
+    uint8_t allowed[GATEWAY_MAX_NODES][6]; // địa chỉ leaf đã đăng ký
+    uint16_t allowedCount;
+
+    Record batch[GATEWAY_BATCH_MAX]; // routine, cũ nhất ở đầu
+    uint8_t batchCount;
+    uint64_t batchStartUs;
+
+    Record alarms[GATEWAY_ALARM_MAX]; // ring, cũ nhất tại alarmHead
+    uint8_t alarmHead;
+    uint8_t alarmCount;
+
+    char payload[GATEWAY_PAYLOAD_SIZE];
+    GatewayStats counters;
+};
+
+#endif
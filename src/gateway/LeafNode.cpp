@@ -0,0 +1,18 @@
+#include "LeafNode.h"
+#include "telemetry/TimeBase.h"
+
+LeafNode::LeafNode(LinkTransport& l, uint32_t id, uint8_t boot)
+    : link(l), nodeId(id), bootId(boot ? boot : 1), seq(0), sent(0), failed(0) {}
+
+bool LeafNode::send(const SensorData& data) {
+    uint8_t frame[NODE_FRAME_SIZE];
+    size_t len = encodeNodeFrame(data, nodeId, bootId, ++seq, monotonicUs(), frame, sizeof(frame));
+
+    int repeats = data.priority == PRIORITY_ALARM ? LEAF_ALARM_REPEATS : 1;
+    bool ok = false;
+    for (int i = 0; i < repeats; i++) ok |= link.send(frame, len);
+
+    if (ok) sent++;
+    else failed++;
+    return ok;
+}
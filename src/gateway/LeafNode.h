@@ -0,0 +1,31 @@
+#ifndef LEAFNODE_H
+#define LEAFNODE_H
+
+#include "LinkTransport.h"
+#include "NodeFrame.h"
+
+// Alarm gửi lặp cùng seq (gateway bỏ bản trùng) vì frame broadcast ESP-NOW không có ACK
+#define LEAF_ALARM_REPEATS 3
+
+// Nút lá: không TLS/AWS, gửi từng bản ghi tới gateway qua LinkTransport
+class LeafNode {
+  public:
+    // bootId: khác 0 và đổi sau mỗi lần khởi động (esp_random()), xem NodeFrame.h
+    LeafNode(LinkTransport& link, uint32_t nodeId, uint8_t bootId);
+
+    bool send(const SensorData& data);
+
+    uint32_t getNodeId() const { return nodeId; }
+    unsigned long getSent() const { return sent; }
+    unsigned long getFailed() const { return failed; }
+
+  private:
+    LinkTransport& link;
+    uint32_t nodeId;
+    uint8_t bootId;
+    uint16_t seq;
+    unsigned long sent;
+    unsigned long failed;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef LINKTRANSPORT_H
+#define LINKTRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LINK_MAX_FRAME 250 // giới hạn payload của ESP-NOW
+
+// Một frame nhận được, kèm địa chỉ nguồn (MAC với ESP-NOW, IP:port với UDP trên host)
+struct LinkFrame {
+    uint8_t src[6];
+    uint8_t len;
+    uint8_t data[LINK_MAX_FRAME];
+};
+
+// Lớp liên kết giữa leaf và gateway. Trên ESP32 là ESP-NOW (EspNowTransport),
+// trên host là loopback/UDP (tools/gateway_sim) để test và đo thông lượng gateway.
+class LinkTransport {
+  public:
+    virtual ~LinkTransport() {}
+    virtual bool begin() = 0;
+    virtual bool send(const uint8_t* data, size_t len) = 0; // leaf → gateway
+    virtual bool receive(LinkFrame& frame) = 0;             // không chặn, false nếu chưa có frame
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "NodeFrame.h"
+#include <math.h>
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+size_t encodeNodeFrame(const SensorData& data, uint32_t nodeId, uint8_t boot, uint16_t seq, uint64_t nowUs,
+                       uint8_t* out, size_t size) {
+    if (size < NODE_FRAME_SIZE) return 0;
+
+    uint8_t flags = 0;
+    if (data.flame) flags |= NODE_FLAG_FLAME;
+    if (data.danger) flags |= NODE_FLAG_DANGER;
+    if (data.priority == PRIORITY_ALARM) flags |= NODE_FLAG_ALARM;
+
+    uint64_t ageMs = nowUs > data.capturedUs ? (nowUs - data.capturedUs) / 1000 : 0;
+    int gas = data.gas < 0 ? 0 : (data.gas > 0xFFFF ? 0xFFFF : data.gas);
+
+    out[0] = NODE_FRAME_MAGIC;
+    out[1] = NODE_FRAME_VERSION;
+    out[2] = flags;
+    out[3] = boot;
+    put32(out + 4, nodeId);
+    put16(out + 8, seq);
+    put16(out + 10, (uint16_t)(int16_t)lroundf(data.temp * 10));
+    put16(out + 12, (uint16_t)lroundf(data.hum * 10));
+    put16(out + 14, (uint16_t)gas);
+    put32(out + 16, ageMs > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)ageMs);
+    return NODE_FRAME_SIZE;
+}
+
+bool decodeNodeFrame(const uint8_t* in, size_t len, uint64_t nowUs, NodeFrame& frame) {
+    if (len < NODE_FRAME_SIZE || in[0] != NODE_FRAME_MAGIC || in[1] != NODE_FRAME_VERSION) return false;
+
+    uint8_t flags = in[2];
+    frame.nodeId = get32(in + 4);
+    frame.seq = get16(in + 8);
+    frame.boot = in[3];
+    frame.ageMs = get32(in + 16);
+
+    SensorData& d = frame.data;
+    d.temp = (int16_t)get16(in + 10) / 10.0f;
+    d.hum = get16(in + 12) / 10.0f;
+    d.gas = get16(in + 14);
+    d.flame = flags & NODE_FLAG_FLAME;
+    d.danger = flags & NODE_FLAG_DANGER;
+    d.priority = (flags & NODE_FLAG_ALARM) ? PRIORITY_ALARM : PRIORITY_ROUTINE;
+    uint64_t ageUs = (uint64_t)frame.ageMs * 1000;
+    d.capturedUs = nowUs > ageUs ? nowUs - ageUs : 0;
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef NODEFRAME_H
+#define NODEFRAME_H
+
+#include "telemetry/SensorData.h"
+
+// Frame nhị phân leaf → gateway, 20 byte little-endian:
+//   magic:u8 version:u8 flags:u8 boot:u8 | nodeId:u32 | seq:u16
+//   temp:i16 (x10) | hum:u16 (x10) | gas:u16 | ageMs:u32
+// ageMs = thời gian từ lúc đo đến lúc gửi; gateway quy về đồng hồ của nó, leaf không cần SNTP.
+// boot = số ngẫu nhiên khác 0 chọn mỗi lần leaf khởi động; seq đếm lại từ 1 sau reboot, gateway
+// thấy boot đổi thì bỏ lịch sử seq của node thay vì coi frame mới là bản trùng.
+#define NODE_FRAME_MAGIC 0x5A
+#define NODE_FRAME_VERSION 1
+#define NODE_FRAME_SIZE 20
+
+#define NODE_FLAG_FLAME 0x01
+#define NODE_FLAG_DANGER 0x02
+#define NODE_FLAG_ALARM 0x04
+
+struct NodeFrame {
+    uint32_t nodeId;
+    uint16_t seq;
+    uint8_t boot;
+    uint32_t ageMs;
+    SensorData data; // capturedUs tính lại theo đồng hồ bên nhận
+};
+
+size_t encodeNodeFrame(const SensorData& data, uint32_t nodeId, uint8_t boot, uint16_t seq, uint64_t nowUs,
+                       uint8_t* out, size_t size);
+
+// false nếu sai magic/version/độ dài
+bool decodeNodeFrame(const uint8_t* in, size_t len, uint64_t nowUs, NodeFrame& frame);
+
+// Node ID = 4 byte cuối của địa chỉ nguồn (MAC). Leaf dùng để đặt ID, gateway dùng để kiểm tra
+// frame đúng là của leaf gửi nó (không giả ID của leaf khác)
+inline uint32_t nodeIdFromAddress(const uint8_t addr[6]) {
+    return ((uint32_t)addr[2] << 24) | ((uint32_t)addr[3] << 16) | ((uint32_t)addr[4] << 8) | addr[5];
+}
+
+#endif
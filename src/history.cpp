@@ -0,0 +1,139 @@
+#include "history.h"
+#include "aws_mqtt.h"
+#include "aws_config.h"
+#include <ArduinoJson.h>
+#include "telemetry/TimeBase.h"
+#include "logging/Logger.h"
+
+#ifndef AWS_IOT_HISTORY_TOPIC
+#define AWS_IOT_HISTORY_TOPIC "esp32/history"
+#endif
+
+static HistoryStore store;
+
+// ------------------ GHI ------------------
+void recordHistory(float temp, float hum, int gas) {
+    // Chưa có giờ thực (trước SNTP): block mở với mốc ~1970 làm delta đầu tiên sau sync rất lớn,
+    // hỏng giả định delta-of-delta và truy vấn theo khoảng thời gian → bỏ điểm này
+    if (!timeBaseValid()) return;
+
+    uint32_t ts = (uint32_t)(toEpochMs(monotonicUs()) / 1000);
+    float values[GORILLA_CHANNELS] = {temp, hum, (float)gas};
+
+    if (store.add(ts, values)) {
+        HistoryStats s = store.stats();
+        LOG_I("[HIST] %u points in %u B (%.2f B/point), %u blocks",
+              s.points, s.bytes, s.points ? (double)s.bytes / s.points : 0.0, s.blocks);
+    }
+}
+
+size_t historyLatest(HistoryChannel channel, float* out, size_t max) {
+    return store.latest(channel, out, max);
+}
+
+HistoryStats historyStats() { return store.stats(); }
+
+// ------------------ TRUY VẤN ------------------
+// Gửi từng block trong loop() để không chặn vòng cảm biến khi trả 24 giờ dữ liệu
+static bool queryActive = false;
+static uint32_t queryFrom = 0, queryTo = 0;
+static uint32_t queryLastId = 0;    // id của block vừa gửi (block đang ghi có thể lớn thêm, không gửi lại)
+static uint16_t querySeq = 0;
+static uint32_t queryPoints = 0, queryBytes = 0;
+static uint64_t queryStartUs = 0, queryEncodeUs = 0;
+
+static const char B64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t base64Encode(const uint8_t* in, size_t len, char* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[n++] = B64[(v >> 18) & 0x3F];
+        out[n++] = B64[(v >> 12) & 0x3F];
+        out[n++] = i + 1 < len ? B64[(v >> 6) & 0x3F] : '=';
+        out[n++] = i + 2 < len ? B64[v & 0x3F] : '=';
+    }
+    out[n] = '\0';
+    return n;
+}
+
+bool handleHistoryCommand(const byte* payload, unsigned int length) {
+    StaticJsonDocument<128> doc;
+    if (deserializeJson(doc, payload, length)) return false;
+    const char* cmd = doc["cmd"];
+    if (!cmd || strcmp(cmd, "history") != 0) return false;
+
+    queryFrom = doc["from"] | 0UL;
+    queryTo = doc["to"] | 0xFFFFFFFFUL;
+    querySeq = 0;
+    queryPoints = queryBytes = 0;
+    queryEncodeUs = 0;
+    queryStartUs = monotonicUs();
+    queryActive = true;
+    LOG_I("[HIST] Query %u..%u", queryFrom, queryTo);
+    return true;
+}
+
+// Block cũ nhất còn lại của truy vấn, nullptr nếu đã hết
+static const GorillaBlock* nextQueryBlock(uint32_t* id) {
+    for (uint8_t i = 0; i < store.blockCount(); i++) {
+        const GorillaBlock& b = store.block(i);
+        if (b.count() == 0 || b.lastTs() < queryFrom || b.firstTs() > queryTo) continue;
+        if (querySeq > 0 && store.blockId(i) <= queryLastId) continue; // đã gửi
+        *id = store.blockId(i);
+        return &b;
+    }
+    return nullptr;
+}
+
+static void finishQuery() {
+    uint64_t totalUs = monotonicUs() - queryStartUs;
+    char msg[256];
+    snprintf(msg, sizeof(msg),
+             "{\"deviceId\":\"%s\",\"type\":\"history_end\",\"from\":%lu,\"to\":%lu,\"blocks\":%u,"
+             "\"points\":%lu,\"bytes\":%lu,\"bytesPerPoint\":%.2f,\"encodeUs\":%lu,\"totalUs\":%lu}",
+             AWS_IOT_CLIENT_ID, (unsigned long)queryFrom, (unsigned long)queryTo, querySeq,
+             (unsigned long)queryPoints, (unsigned long)queryBytes,
+             queryPoints ? (double)queryBytes / queryPoints : 0.0,
+             (unsigned long)queryEncodeUs, (unsigned long)totalUs);
+    if (!publishMessage(AWS_IOT_HISTORY_TOPIC, msg)) return; // thử lại lượt sau
+
+    LOG_I("[HIST] Query done: %u blocks, %lu points, %lu B, encode %lu us, total %lu us",
+          querySeq, (unsigned long)queryPoints, (unsigned long)queryBytes,
+          (unsigned long)queryEncodeUs, (unsigned long)totalUs);
+    queryActive = false;
+}
+
+void loopHistory() {
+    if (!queryActive || !isAWSConnected()) return;
+
+    uint64_t t0 = monotonicUs();
+    uint32_t id;
+    const GorillaBlock* b = nextQueryBlock(&id);
+    if (!b) {
+        finishQuery();
+        return;
+    }
+
+    // Block gửi nguyên trạng (có thể vượt ra ngoài from/to), bên nhận tự lọc theo timestamp
+    char data[(GORILLA_BLOCK_BYTES + 2) / 3 * 4 + 1];
+    base64Encode(b->data(), b->byteLength(), data);
+
+    static char msg[600];
+    snprintf(msg, sizeof(msg),
+             "{\"deviceId\":\"%s\",\"type\":\"history\",\"seq\":%u,\"firstTs\":%lu,\"lastTs\":%lu,"
+             "\"count\":%u,\"bits\":%u,\"scale\":[%g,%g,%g],\"data\":\"%s\"}",
+             AWS_IOT_CLIENT_ID, querySeq, (unsigned long)b->firstTs(), (unsigned long)b->lastTs(),
+             b->count(), (unsigned)b->bitLength(), GORILLA_SCALE[0], GORILLA_SCALE[1], GORILLA_SCALE[2],
+             data);
+    queryEncodeUs += monotonicUs() - t0;
+
+    if (!publishMessage(AWS_IOT_HISTORY_TOPIC, msg)) return; // giữ nguyên vị trí, thử lại
+
+    querySeq++;
+    queryPoints += b->count();
+    queryBytes += b->byteLength();
+    queryLastId = id;
+}
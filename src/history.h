@@ -0,0 +1,25 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "history/HistoryStore.h"
+
+// Lịch sử nén Gorilla trong RAM: 24 giờ, 1 điểm/phút (~2-4 byte/điểm cho 3 kênh)
+#define HISTORY_INTERVAL_MS 60000
+
+enum HistoryChannel : uint8_t { HISTORY_TEMP = 0, HISTORY_HUM = 1, HISTORY_GAS = 2 };
+
+void recordHistory(float temp, float hum, int gas); // gọi mỗi HISTORY_INTERVAL_MS
+void loopHistory();                                 // gửi dần kết quả truy vấn, 1 block/lượt
+
+// Điểm gần nhất của một kênh cho trang biểu đồ OLED, cũ → mới
+size_t historyLatest(HistoryChannel channel, float* out, size_t max);
+HistoryStats historyStats();
+
+// Lệnh truy vấn qua MQTT (from/to: epoch giây, bỏ trống = cả 24 giờ):
+// {"cmd":"history","from":1760000000,"to":1760086400}
+// Trả lời trên AWS_IOT_HISTORY_TOPIC: mỗi block một message (Gorilla, base64) rồi một message
+// tổng kết (số điểm, byte/điểm, độ trễ). Giải mã: tools/history_decode/history_decode.py
+bool handleHistoryCommand(const byte* payload, unsigned int length);
+
+#endif
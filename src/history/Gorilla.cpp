@@ -0,0 +1,201 @@
+#include "Gorilla.h"
+#include <string.h>
+#include <math.h>
+
+const float GORILLA_SCALE[GORILLA_CHANNELS] = {10, 10, 1};
+
+static uint32_t floatBits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bitsFloat(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static const uint8_t NO_WINDOW = 0xFF; // chưa có cửa sổ leading/trailing để dùng lại
+
+static uint32_t quantize(float value, uint8_t ch) {
+    return floatBits(roundf(value * GORILLA_SCALE[ch]));
+}
+
+// ------------------ ENCODER ------------------
+GorillaBlock::GorillaBlock() { reset(); }
+
+void GorillaBlock::reset() {
+    memset(bytes, 0, sizeof(bytes));
+    bits = 0;
+    points = 0;
+    t0 = prevTs = 0;
+    prevDelta = 0;
+    memset(prevValue, 0, sizeof(prevValue));
+    memset(prevLeading, NO_WINDOW, sizeof(prevLeading));
+    memset(prevTrailing, 0, sizeof(prevTrailing));
+}
+
+// Ghi nbits bit thấp của value, bit cao trước
+void GorillaBlock::put(uint32_t value, uint8_t nbits) {
+    while (nbits > 0) {
+        nbits--;
+        if ((value >> nbits) & 1) bytes[bits >> 3] |= 0x80 >> (bits & 7);
+        bits++;
+    }
+}
+
+// '0' = trùng giá trị trước
+// '10' + bit có nghĩa, dùng lại cửa sổ leading/trailing trước
+// '11' + leading(5) + length-1(5) + bit có nghĩa
+void GorillaBlock::putValue(uint8_t ch, uint32_t value) {
+    uint32_t x = value ^ prevValue[ch];
+    prevValue[ch] = value;
+    if (x == 0) {
+        put(0, 1);
+        return;
+    }
+
+    uint8_t leading = __builtin_clz(x);
+    uint8_t trailing = __builtin_ctz(x);
+    uint8_t length = 32 - leading - trailing;
+
+    // Dùng lại cửa sổ cũ nếu vừa và không tốn hơn header mới (10 bit)
+    if (prevLeading[ch] != NO_WINDOW && leading >= prevLeading[ch] && trailing >= prevTrailing[ch]) {
+        uint8_t prevLength = 32 - prevLeading[ch] - prevTrailing[ch];
+        if (prevLength <= length + 10) {
+            put(0b10, 2);
+            put(x >> prevTrailing[ch], prevLength);
+            return;
+        }
+    }
+
+    put(0b11, 2);
+    put(leading, 5);
+    put(length - 1, 5);
+    put(x >> trailing, length);
+    prevLeading[ch] = leading;
+    prevTrailing[ch] = trailing;
+}
+
+bool GorillaBlock::append(uint32_t ts, const float values[GORILLA_CHANNELS]) {
+    if (bits + GORILLA_MAX_POINT_BITS > GORILLA_BLOCK_BYTES * 8) return false;
+
+    if (points == 0) {
+        t0 = prevTs = ts;
+        put(ts, 32);
+        for (uint8_t ch = 0; ch < GORILLA_CHANNELS; ch++) {
+            prevValue[ch] = quantize(values[ch], ch);
+            put(prevValue[ch], 32);
+        }
+        points = 1;
+        return true;
+    }
+
+    if (ts < prevTs) return false; // đồng hồ bị chỉnh lùi → bắt đầu block mới
+    int32_t delta = (int32_t)(ts - prevTs);
+
+    if (points == 1) {
+        if (delta >= (1 << 14)) return false; // delta đầu tiên lưu 14 bit
+        put(delta, 14);
+    } else {
+        int32_t dod = delta - prevDelta;
+        if (dod == 0) {
+            put(0, 1);
+        } else if (dod >= -64 && dod <= 63) {
+            put(0b10, 2);
+            put((uint32_t)dod & 0x7F, 7);
+        } else if (dod >= -256 && dod <= 255) {
+            put(0b110, 3);
+            put((uint32_t)dod & 0x1FF, 9);
+        } else if (dod >= -2048 && dod <= 2047) {
+            put(0b1110, 4);
+            put((uint32_t)dod & 0xFFF, 12);
+        } else {
+            put(0b1111, 4);
+            put((uint32_t)dod, 32);
+        }
+    }
+    prevDelta = delta;
+    prevTs = ts;
+
+    for (uint8_t ch = 0; ch < GORILLA_CHANNELS; ch++) putValue(ch, quantize(values[ch], ch));
+    points++;
+    return true;
+}
+
+// ------------------ DECODER ------------------
+GorillaReader::GorillaReader(const uint8_t* d, size_t len, uint16_t count)
+    : data(d), bitLength(len), pos(0), remaining(count), index(0), prevTs(0), prevDelta(0) {
+    memset(prevValue, 0, sizeof(prevValue));
+    memset(prevLeading, 0, sizeof(prevLeading));
+    memset(prevTrailing, 0, sizeof(prevTrailing));
+}
+
+uint32_t GorillaReader::get(uint8_t nbits) {
+    uint32_t value = 0;
+    while (nbits > 0) {
+        nbits--;
+        uint32_t bit = pos < bitLength ? (data[pos >> 3] >> (7 - (pos & 7))) & 1 : 0;
+        value = (value << 1) | bit;
+        pos++;
+    }
+    return value;
+}
+
+// Mở rộng dấu cho giá trị n bit
+static int32_t signExtend(uint32_t value, uint8_t nbits) {
+    uint32_t sign = 1u << (nbits - 1);
+    return (int32_t)((value ^ sign) - sign);
+}
+
+uint32_t GorillaReader::getValue(uint8_t ch) {
+    if (get(1) == 0) return prevValue[ch];
+
+    if (get(1) == 0) {
+        uint8_t length = 32 - prevLeading[ch] - prevTrailing[ch];
+        prevValue[ch] ^= get(length) << prevTrailing[ch];
+        return prevValue[ch];
+    }
+
+    uint8_t leading = get(5);
+    uint8_t length = get(5) + 1;
+    uint8_t trailing = 32 - leading - length;
+    prevValue[ch] ^= get(length) << trailing;
+    prevLeading[ch] = leading;
+    prevTrailing[ch] = trailing;
+    return prevValue[ch];
+}
+
+bool GorillaReader::next(uint32_t& ts, float values[GORILLA_CHANNELS]) {
+    if (remaining == 0) return false;
+
+    if (index == 0) {
+        prevTs = get(32);
+        for (uint8_t ch = 0; ch < GORILLA_CHANNELS; ch++) prevValue[ch] = get(32);
+    } else {
+        if (index == 1) {
+            prevDelta = get(14);
+        } else if (get(1) == 0) {
+            // dod = 0, giữ nguyên delta
+        } else if (get(1) == 0) {
+            prevDelta += signExtend(get(7), 7);
+        } else if (get(1) == 0) {
+            prevDelta += signExtend(get(9), 9);
+        } else if (get(1) == 0) {
+            prevDelta += signExtend(get(12), 12);
+        } else {
+            prevDelta += (int32_t)get(32);
+        }
+        prevTs += prevDelta;
+        for (uint8_t ch = 0; ch < GORILLA_CHANNELS; ch++) getValue(ch);
+    }
+
+    ts = prevTs;
+    for (uint8_t ch = 0; ch < GORILLA_CHANNELS; ch++) {
+        values[ch] = bitsFloat(prevValue[ch]) / GORILLA_SCALE[ch];
+    }
+    index++;
+    remaining--;
+    return true;
+}
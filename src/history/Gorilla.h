@@ -0,0 +1,75 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Nén chuỗi thời gian kiểu Gorilla (Facebook, VLDB 2015):
+// - timestamp: delta-of-delta, chu kỳ đều → 1 bit/điểm
+// - giá trị: XOR với giá trị trước, chỉ lưu các bit có nghĩa
+// Giá trị được lượng tử hóa trước khi nén (nhiệt độ/độ ẩm 0.1, gas 1) và lưu dưới dạng float
+// nguyên (284.0 thay vì 28.4) → XOR giữa 2 phút liền nhau chỉ còn vài bit.
+
+#define GORILLA_CHANNELS 3           // nhiệt độ, độ ẩm, gas
+#define GORILLA_BLOCK_BYTES 256
+#define GORILLA_MAX_POINT_BITS (36 + GORILLA_CHANNELS * 44) // trường hợp xấu nhất của 1 điểm
+
+// Hệ số lượng tử của từng kênh: lưu round(value * scale)
+extern const float GORILLA_SCALE[GORILLA_CHANNELS];
+
+// Một block nén độc lập (header nằm trong chính luồng bit: t0 + giá trị đầu tiên)
+class GorillaBlock {
+  public:
+    GorillaBlock();
+    void reset();
+
+    // false nếu block không đủ chỗ hoặc timestamp lùi/nhảy quá xa → cần block mới
+    bool append(uint32_t ts, const float values[GORILLA_CHANNELS]);
+
+    uint16_t count() const { return points; }
+    uint32_t firstTs() const { return t0; }
+    uint32_t lastTs() const { return prevTs; }
+    size_t bitLength() const { return bits; }
+    size_t byteLength() const { return (bits + 7) / 8; }
+    const uint8_t* data() const { return bytes; }
+
+  private:
+    void put(uint32_t value, uint8_t nbits);
+    void putValue(uint8_t ch, uint32_t value);
+
+    uint8_t bytes[GORILLA_BLOCK_BYTES];
+    size_t bits;
+    uint16_t points;
+    uint32_t t0;
+    uint32_t prevTs;
+    int32_t prevDelta;
+    uint32_t prevValue[GORILLA_CHANNELS];
+    uint8_t prevLeading[GORILLA_CHANNELS];
+    uint8_t prevTrailing[GORILLA_CHANNELS];
+};
+
+// Giải nén tuần tự một block
+class GorillaReader {
+  public:
+    GorillaReader(const uint8_t* data, size_t bitLength, uint16_t count);
+
+    // false khi hết điểm
+    bool next(uint32_t& ts, float values[GORILLA_CHANNELS]);
+
+  private:
+    uint32_t get(uint8_t nbits);
+    uint32_t getValue(uint8_t ch);
+
+    const uint8_t* data;
+    size_t bitLength;
+    size_t pos;
+    uint16_t remaining;
+    uint16_t index;
+    uint32_t prevTs;
+    int32_t prevDelta;
+    uint32_t prevValue[GORILLA_CHANNELS];
+    uint8_t prevLeading[GORILLA_CHANNELS];
+    uint8_t prevTrailing[GORILLA_CHANNELS];
+};
+
+#endif
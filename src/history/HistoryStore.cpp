@@ -0,0 +1,68 @@
+#include "HistoryStore.h"
+
+HistoryStore::HistoryStore() : nextId(0), head(0), used(0) {}
+
+bool HistoryStore::add(uint32_t ts, const float values[GORILLA_CHANNELS]) {
+    if (used == 0) {
+        used = 1;
+        ids[head] = nextId++;
+    }
+
+    GorillaBlock& current = blocks[head];
+    if (current.count() < HISTORY_BLOCK_POINTS && current.append(ts, values)) return false;
+
+    // Block đầy (hoặc timestamp nhảy) → chuyển sang block kế tiếp, ghi đè block cũ nhất
+    head = (head + 1) % HISTORY_BLOCKS;
+    if (used < HISTORY_BLOCKS) used++;
+    ids[head] = nextId++;
+    blocks[head].reset();
+    blocks[head].append(ts, values);
+    return true;
+}
+
+const GorillaBlock& HistoryStore::block(uint8_t i) const { return blocks[slot(i)]; }
+
+uint32_t HistoryStore::blockId(uint8_t i) const { return ids[slot(i)]; }
+
+size_t HistoryStore::latest(uint8_t channel, float* out, size_t max) const {
+    if (channel >= GORILLA_CHANNELS || max == 0) return 0;
+
+    // Lùi từ block mới nhất cho đến khi đủ số điểm
+    uint8_t first = used;
+    size_t total = 0;
+    while (first > 0 && total < max) {
+        first--;
+        total += block(first).count();
+    }
+
+    size_t skip = total > max ? total - max : 0;
+    size_t n = 0;
+    uint32_t ts;
+    float values[GORILLA_CHANNELS];
+    for (uint8_t i = first; i < used; i++) {
+        const GorillaBlock& b = block(i);
+        GorillaReader reader(b.data(), b.bitLength(), b.count());
+        while (reader.next(ts, values)) {
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            out[n++] = values[channel];
+        }
+    }
+    return n;
+}
+
+HistoryStats HistoryStore::stats() const {
+    HistoryStats s = {0, 0, 0, 0, used};
+    for (uint8_t i = 0; i < used; i++) {
+        const GorillaBlock& b = block(i);
+        s.points += b.count();
+        s.bytes += b.byteLength();
+    }
+    if (used > 0) {
+        s.firstTs = block(0).firstTs();
+        s.lastTs = block(used - 1).lastTs();
+    }
+    return s;
+}
@@ -0,0 +1,45 @@
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include "Gorilla.h"
+
+// 24 giờ ở độ phân giải 1 phút: 24 block đầy (1 giờ/block) + block đang ghi
+#define HISTORY_BLOCKS 25
+#define HISTORY_BLOCK_POINTS 60
+
+struct HistoryStats {
+    uint32_t points;
+    uint32_t bytes;     // byte nén đang dùng (không tính phần trống của block)
+    uint32_t firstTs;
+    uint32_t lastTs;
+    uint8_t blocks;
+};
+
+// Vòng các block Gorilla, đầy thì ghi đè block cũ nhất
+class HistoryStore {
+  public:
+    HistoryStore();
+
+    // Trả về true nếu vừa đóng một block (để log thống kê nén)
+    bool add(uint32_t ts, const float values[GORILLA_CHANNELS]);
+
+    uint8_t blockCount() const { return used; }
+    const GorillaBlock& block(uint8_t i) const; // 0 = cũ nhất
+    uint32_t blockId(uint8_t i) const;          // số thứ tự tăng dần, không đổi khi vòng quay
+
+    // max điểm gần nhất của một kênh, cũ → mới; trả về số điểm đã ghi
+    size_t latest(uint8_t channel, float* out, size_t max) const;
+
+    HistoryStats stats() const;
+
+  private:
+    uint8_t slot(uint8_t i) const { return (head + HISTORY_BLOCKS - used + 1 + i) % HISTORY_BLOCKS; }
+
+    GorillaBlock blocks[HISTORY_BLOCKS];
+    uint32_t ids[HISTORY_BLOCKS];
+    uint32_t nextId;
+    uint8_t head; // block đang ghi
+    uint8_t used;
+};
+
+#endif
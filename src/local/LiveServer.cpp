@@ -0,0 +1,115 @@
+#include "LiveServer.h"
+#include "aws_config.h"
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <ESPAsyncWebServer.h>
+#include "telemetry/SensorData.h"
+#include "telemetry/TimeBase.h"
+#include "logging/Logger.h"
+
+static AsyncWebServer server(LIVE_HTTP_PORT);
+static AsyncEventSource events("/events");
+static bool started = false;
+
+// ------------------ FRAME DÙNG CHUNG ------------------
+// Serialize một lần mỗi lần cập nhật; mọi client nhận cùng buffer.
+// Callback của AsyncTCP chạy ở task khác → đọc/ghi frame trong critical section.
+static char frame[300];
+static size_t frameLen = 0;
+static uint32_t frameId = 0;
+static portMUX_TYPE frameMux = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t copyFrame(char* out, size_t size, uint32_t& id) {
+    portENTER_CRITICAL(&frameMux);
+    size_t len = frameLen < size ? frameLen : size - 1;
+    memcpy(out, frame, len);
+    id = frameId;
+    portEXIT_CRITICAL(&frameMux);
+    out[len] = '\0';
+    return len;
+}
+
+// ------------------ TRANG XEM NHANH ------------------
+static const char INDEX_HTML[] PROGMEM = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><meta name="viewport" content="width=device-width,initial-scale=1">
+<title>Smart Home Live</title>
+<style>body{font-family:sans-serif;margin:2em}td{padding:.3em 1em}.bad{color:#c00;font-weight:bold}</style>
+</head><body><h2>Smart Home Live</h2>
+<table><tr><td>Temperature</td><td id="t">-</td></tr><tr><td>Humidity</td><td id="h">-</td></tr>
+<tr><td>Gas</td><td id="g">-</td></tr><tr><td>Flame</td><td id="f">-</td></tr>
+<tr><td>Status</td><td id="s">-</td></tr><tr><td>Age</td><td id="a">-</td></tr></table>
+<script>
+var last=0;
+function show(d){document.getElementById('t').textContent=d.temperature.toFixed(1)+' °C';
+document.getElementById('h').textContent=d.humidity.toFixed(1)+' %';
+document.getElementById('g').textContent=d.gas;
+document.getElementById('f').textContent=d.alert.flame?'YES':'NO';
+var s=document.getElementById('s');s.textContent=d.alert.danger?'DANGER':'OK';s.className=d.alert.danger?'bad':'';
+last=Date.now();}
+setInterval(function(){if(last)document.getElementById('a').textContent=((Date.now()-last)/1000).toFixed(0)+' s';},1000);
+var es=new EventSource('/events');
+es.addEventListener('reading',function(e){show(JSON.parse(e.data));});
+</script></body></html>)HTML";
+
+// ------------------ KHỞI ĐỘNG ------------------
+static void startServer() {
+    events.onConnect([](AsyncEventSourceClient* c) {
+        if (events.count() > LIVE_MAX_CLIENTS) { // quá nhiều client → từ chối, tránh cạn heap
+            c->close();
+            return;
+        }
+        // Client mới nhận ngay frame gần nhất, không phải chờ lần cập nhật sau
+        char buf[sizeof(frame)];
+        uint32_t id;
+        if (copyFrame(buf, sizeof(buf), id) > 0) c->send(buf, "reading", id);
+    });
+    server.addHandler(&events);
+
+    server.on("/", HTTP_GET, [](AsyncWebServerRequest* req) {
+        req->send_P(200, "text/html", INDEX_HTML);
+    });
+    server.on("/api/snapshot", HTTP_GET, [](AsyncWebServerRequest* req) {
+        char buf[sizeof(frame)];
+        uint32_t id;
+        if (copyFrame(buf, sizeof(buf), id) == 0) {
+            req->send(503, "application/json", "{\"error\":\"no data yet\"}");
+            return;
+        }
+        req->send(200, "application/json", buf);
+    });
+    server.begin();
+
+    if (MDNS.begin(LIVE_HOSTNAME)) {
+        MDNS.addService("http", "tcp", LIVE_HTTP_PORT);
+        LOG_I("[LIVE] http://%s.local/ (%s)", LIVE_HOSTNAME, WiFi.localIP().toString().c_str());
+    } else {
+        LOG_W("[LIVE] mDNS failed, use http://%s/", WiFi.localIP().toString().c_str());
+    }
+    started = true;
+}
+
+void loopLiveServer() {
+    if (!started && WiFi.status() == WL_CONNECTED) startServer();
+}
+
+// ------------------ PHÁT DỮ LIỆU ------------------
+void publishLive(float temp, float hum, int gas, bool flame, bool danger) {
+    if (!started) return;
+
+    SensorData data = {temp, hum, gas, flame, danger, PRIORITY_ROUTINE, monotonicUs()};
+    char buf[sizeof(frame)];
+    size_t len = serializeSensorData(data, AWS_IOT_CLIENT_ID, buf, sizeof(buf));
+
+    uint32_t id;
+    portENTER_CRITICAL(&frameMux);
+    memcpy(frame, buf, len + 1);
+    frameLen = len;
+    id = ++frameId;
+    portEXIT_CRITICAL(&frameMux);
+
+    // Không có client thì chỉ giữ frame cho /api/snapshot
+    // AsyncEventSource tự bỏ message của client chậm khi hàng đợi của nó đầy
+    if (events.count() > 0) events.send(buf, "reading", id);
+}
+
+size_t liveClientCount() { return started ? events.count() : 0; }
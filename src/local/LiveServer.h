@@ -0,0 +1,21 @@
+#ifndef LIVESERVER_H
+#define LIVESERVER_H
+
+#include <Arduino.h>
+
+// Xem trực tiếp trong mạng LAN, không phụ thuộc AWS/internet:
+//   http://smarthome.local/            trang xem nhanh
+//   http://smarthome.local/events      Server-Sent Events, event "reading"
+//   http://smarthome.local/api/snapshot JSON mới nhất
+#define LIVE_HOSTNAME "smarthome"
+#define LIVE_HTTP_PORT 80
+#define LIVE_MAX_CLIENTS 4
+
+void loopLiveServer(); // gọi trong loop(); khởi động server + mDNS khi có WiFi
+
+// Đóng gói snapshot một lần rồi phát cho mọi client (cùng JSON với AWS)
+void publishLive(float temp, float hum, int gas, bool flame, bool danger);
+
+size_t liveClientCount();
+
+#endif
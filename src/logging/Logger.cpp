@@ -0,0 +1,272 @@
+#include "Logger.h"
+#include <atomic>
+#include <stdio.h>
+
+using namespace logdetail;
+
+// ------------------ RING BUFFER ------------------
+// head/tail là bộ đếm tăng dần (không quấn), vị trí thật = giá trị & (LOG_RING_SIZE - 1)
+static uint8_t ring[LOG_RING_SIZE];
+static std::atomic<uint32_t> ringHead(0); // chỉ producer (loop) ghi
+static std::atomic<uint32_t> ringTail(0); // chỉ consumer (task log) ghi
+static std::atomic<uint32_t> dropped(0);
+static uint32_t reportedDropped = 0;
+
+static const uint8_t BINARY_SYNC = 0xA5;
+static const uint8_t LEVEL_DROPPED = 0xFF; // bản ghi đặc biệt báo số log bị bỏ (chế độ binary)
+
+static void ringCopyIn(uint32_t at, const uint8_t* data, size_t len) {
+    size_t offset = at & (LOG_RING_SIZE - 1);
+    size_t first = LOG_RING_SIZE - offset < len ? LOG_RING_SIZE - offset : len;
+    memcpy(ring + offset, data, first);
+    memcpy(ring, data + first, len - first);
+}
+
+static void ringCopyOut(uint32_t at, uint8_t* data, size_t len) {
+    size_t offset = at & (LOG_RING_SIZE - 1);
+    size_t first = LOG_RING_SIZE - offset < len ? LOG_RING_SIZE - offset : len;
+    memcpy(data, ring + offset, first);
+    memcpy(data + first, ring, len - first);
+}
+
+void logdetail::Encoder::putString(const char* s) {
+    if (!s) s = "(null)";
+    size_t len = strlen(s);
+    if (len > LOG_MAX_STRING) len = LOG_MAX_STRING;
+    if (pos + 2 + len > sizeof(buf)) { // cắt cho vừa bản ghi
+        if (pos + 2 >= sizeof(buf)) {
+            overflow = true;
+            return;
+        }
+        len = sizeof(buf) - pos - 2;
+    }
+    buf[pos++] = ARG_STRING;
+    buf[pos++] = (uint8_t)len;
+    memcpy(buf + pos, s, len);
+    pos += len;
+    count++;
+}
+
+void logdetail::commit(Encoder& e, uint8_t level, const char* fmt) {
+    RecordHeader h;
+    h.length = (uint16_t)e.pos;
+    h.level = level;
+    h.argCount = e.count;
+    h.timeMs = millis();
+    h.fmt = fmt;
+    memcpy(e.buf, &h, sizeof(h));
+
+    uint32_t head = ringHead.load(std::memory_order_relaxed);
+    uint32_t tail = ringTail.load(std::memory_order_acquire);
+    if (LOG_RING_SIZE - (head - tail) < e.pos) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ringCopyIn(head, e.buf, e.pos);
+    ringHead.store(head + e.pos, std::memory_order_release);
+}
+
+unsigned long logDroppedCount() { return dropped.load(std::memory_order_relaxed); }
+
+// ------------------ FORMAT (CHẠY Ở TASK LOG) ------------------
+// Duyệt chuỗi format, mỗi %spec lấy một tham số đã lưu và gọi snprintf cho riêng spec đó
+static size_t formatRecord(const uint8_t* rec, char* out, size_t size) {
+    RecordHeader h;
+    memcpy(&h, rec, sizeof(h));
+    const uint8_t* arg = rec + sizeof(h);
+    const uint8_t* end = rec + h.length;
+    size_t n = 0;
+
+    auto append = [&](int written) {
+        if (written > 0) n += (size_t)written;
+        if (n >= size) n = size - 1;
+    };
+
+    for (const char* p = h.fmt; *p && n < size - 1; p++) {
+        if (*p != '%') {
+            out[n++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[n++] = '%';
+            p++;
+            continue;
+        }
+
+        // Tách flags/width/precision; '*' lấy giá trị từ tham số int kế tiếp như printf.
+        // Bỏ length modifier (l, ll, h, z) vì kiểu đã biết
+        char spec[32] = "%";
+        size_t sl = 1;
+        const char* q = p + 1;
+        while (*q && sl < sizeof(spec) - 16) {
+            if (*q == '*') {
+                int32_t v = 0;
+                if (arg < end && (*arg == ARG_I32 || *arg == ARG_U32)) {
+                    memcpy(&v, arg + 1, 4);
+                    arg += 5;
+                }
+                if (v < 0 && spec[sl - 1] == '.') sl--; // precision âm = không có precision
+                else sl += snprintf(spec + sl, sizeof(spec) - sl, "%d", (int)v);
+                q++;
+            } else if (strchr("-+ #0123456789.", *q)) {
+                spec[sl++] = *q++;
+            } else {
+                break;
+            }
+        }
+        while (*q && strchr("hlzjt", *q)) q++;
+        char conv = *q ? *q : 'd';
+        p = *q ? q : q - 1;
+
+        if (arg >= end) {
+            append(snprintf(out + n, size - n, "?"));
+            continue;
+        }
+
+        ArgType type = (ArgType)*arg++;
+        switch (type) {
+        case ARG_I32:
+        case ARG_U32: {
+            uint32_t v;
+            memcpy(&v, arg, 4);
+            arg += 4;
+            if (conv == 'c') {
+                spec[sl++] = 'c';
+            } else {
+                spec[sl++] = strchr("diouxX", conv) ? conv : (type == ARG_I32 ? 'd' : 'u');
+            }
+            spec[sl] = 0;
+            if (type == ARG_I32) append(snprintf(out + n, size - n, spec, (int)(int32_t)v));
+            else append(snprintf(out + n, size - n, spec, (unsigned)v));
+            break;
+        }
+        case ARG_I64:
+        case ARG_U64: {
+            uint64_t v;
+            memcpy(&v, arg, 8);
+            arg += 8;
+            spec[sl++] = 'l';
+            spec[sl++] = 'l';
+            spec[sl++] = strchr("diouxX", conv) ? conv : (type == ARG_I64 ? 'd' : 'u');
+            spec[sl] = 0;
+            if (type == ARG_I64) append(snprintf(out + n, size - n, spec, (long long)v));
+            else append(snprintf(out + n, size - n, spec, (unsigned long long)v));
+            break;
+        }
+        case ARG_DOUBLE: {
+            double v;
+            memcpy(&v, arg, 8);
+            arg += 8;
+            spec[sl++] = strchr("fFeEgG", conv) ? conv : 'f';
+            spec[sl] = 0;
+            append(snprintf(out + n, size - n, spec, v));
+            break;
+        }
+        case ARG_STRING: {
+            uint8_t len = *arg++;
+            char str[LOG_MAX_STRING + 1]; // chuỗi trong bản ghi không có '\0'
+            memcpy(str, arg, len);
+            str[len] = 0;
+            arg += len;
+            spec[sl++] = 's';
+            spec[sl] = 0;
+            append(snprintf(out + n, size - n, spec, str));
+            break;
+        }
+        case ARG_PTR: {
+            const void* v;
+            memcpy(&v, arg, sizeof(v));
+            arg += sizeof(v);
+            append(snprintf(out + n, size - n, "%p", v));
+            break;
+        }
+        default:
+            arg = end; // bản ghi hỏng, bỏ phần còn lại
+            break;
+        }
+    }
+    out[n] = 0;
+    return n;
+}
+
+static void emitRecord(const uint8_t* rec, size_t len) {
+#if LOG_BINARY
+    Serial.write(BINARY_SYNC);
+    Serial.write(rec, len);
+#else
+    (void)len;
+    char line[320];
+    size_t n = formatRecord(rec, line, sizeof(line) - 2);
+    line[n++] = '\r';
+    line[n++] = '\n';
+    Serial.write((const uint8_t*)line, n);
+#endif
+}
+
+static void reportDropped() {
+    uint32_t now = dropped.load(std::memory_order_relaxed);
+    if (now == reportedDropped) return;
+    reportedDropped = now;
+#if LOG_BINARY
+    Encoder e;
+    encode(e, now);
+    RecordHeader h = {(uint16_t)e.pos, LEVEL_DROPPED, e.count, (uint32_t)millis(), nullptr};
+    memcpy(e.buf, &h, sizeof(h));
+    emitRecord(e.buf, e.pos);
+#else
+    Serial.printf("[LOG] %lu messages dropped (ring full)\r\n", (unsigned long)now);
+#endif
+}
+
+size_t logPoll(size_t maxRecords) {
+    uint8_t rec[LOG_MAX_RECORD];
+    size_t done = 0;
+
+    while (done < maxRecords) {
+        uint32_t tail = ringTail.load(std::memory_order_relaxed);
+        uint32_t head = ringHead.load(std::memory_order_acquire);
+        if (head == tail) break;
+
+        uint16_t len;
+        ringCopyOut(tail, (uint8_t*)&len, sizeof(len));
+        ringCopyOut(tail, rec, len);
+        ringTail.store(tail + len, std::memory_order_release); // trả chỗ cho producer trước khi ghi UART
+
+        emitRecord(rec, len);
+        done++;
+    }
+    reportDropped();
+    return done;
+}
+
+// ------------------ TASK XUẤT LOG ------------------
+#if defined(ESP32)
+static void logTask(void*) {
+    for (;;) {
+        if (logPoll(32) == 0) vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
+
+// Core 0 (cùng WiFi), ưu tiên thấp; loop() chạy ở core 1 nên không bị tranh CPU
+void logBegin() {
+    xTaskCreatePinnedToCore(logTask, "log", 4096, nullptr, tskIDLE_PRIORITY + 1, nullptr, 0);
+}
+
+bool logFlush(unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (ringHead.load(std::memory_order_acquire) != ringTail.load(std::memory_order_acquire)) {
+        if (millis() - start >= timeoutMs) return false;
+        delay(1); // task log đang xuất
+    }
+    Serial.flush(); // chờ FIFO UART trống
+    return true;
+}
+#else
+void logBegin() {}
+
+bool logFlush(unsigned long timeoutMs) {
+    (void)timeoutMs;
+    while (logPoll(32) > 0) {}
+    return true;
+}
+#endif
@@ -0,0 +1,141 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+// Log không chặn: lời gọi LOG_x chỉ chép con trỏ format + giá trị tham số vào ring buffer
+// (chuỗi được chép nội dung). Việc format và ghi UART làm trong task ưu tiên thấp ở core 0,
+// nên loop() không bao giờ phải chờ UART 115200 baud.
+//
+// Mức log lọc lúc biên dịch: build_flags = -DLOG_LEVEL=LOG_LEVEL_DEBUG
+// -DLOG_BINARY=1: ghi bản ghi nhị phân thay vì text, giải mã trên PC bằng tools/log_decode.
+//
+// Ring buffer là single-producer: chỉ gọi LOG_x từ loop() (và các callback chạy trong loop()).
+//
+// Format hỗ trợ: %d %i %u %o %x %X %c %f %F %e %E %g %G %s %p %%, flags "-+ #0", width và
+// precision dạng số hoặc '*' (lấy từ tham số int kế tiếp). Length modifier (hh h l ll z j t)
+// được chấp nhận nhưng bỏ qua: kiểu thật được mã hóa cùng giá trị. Không hỗ trợ %n, %a, %1$d.
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_BINARY
+#define LOG_BINARY 0
+#endif
+
+#define LOG_RING_SIZE 4096   // byte, lũy thừa của 2
+#define LOG_MAX_RECORD 256   // một bản ghi (header + tham số)
+#define LOG_MAX_STRING 192   // chuỗi dài hơn bị cắt
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(fmt, ...) logWrite(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(fmt, ...) logWrite(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(fmt, ...) logWrite(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(fmt, ...) logWrite(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(fmt, ...) do {} while (0)
+#endif
+
+void logBegin();                 // ESP32: tạo task xuất log; host: gọi logPoll() thủ công
+size_t logPoll(size_t maxRecords = 16); // format + xuất tối đa maxRecords bản ghi, trả về số đã xuất
+unsigned long logDroppedCount(); // số bản ghi bị bỏ vì ring đầy
+bool logFlush(unsigned long timeoutMs = 200); // chờ xuất hết log (trước deep sleep), false nếu quá giờ
+
+// ------------------ MÃ HÓA THAM SỐ ------------------
+namespace logdetail {
+
+enum ArgType : uint8_t { ARG_I32, ARG_U32, ARG_I64, ARG_U64, ARG_DOUBLE, ARG_STRING, ARG_PTR };
+
+struct RecordHeader {
+    uint16_t length;   // tổng số byte của bản ghi, kể cả header
+    uint8_t level;
+    uint8_t argCount;
+    uint32_t timeMs;
+    const char* fmt;   // trỏ vào flash (.rodata), không chép chuỗi format
+};
+
+struct Encoder {
+    uint8_t buf[LOG_MAX_RECORD];
+    size_t pos = sizeof(RecordHeader);
+    uint8_t count = 0;
+    bool overflow = false;
+
+    void put(ArgType type, const void* data, size_t len) {
+        if (pos + 1 + len > sizeof(buf)) {
+            overflow = true;
+            return;
+        }
+        buf[pos++] = type;
+        memcpy(buf + pos, data, len);
+        pos += len;
+        count++;
+    }
+    void putString(const char* s);
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+encode(Encoder& e, T v) {
+    if (sizeof(T) <= 4) {
+        if (std::is_signed<T>::value) {
+            int32_t x = (int32_t)v;
+            e.put(ARG_I32, &x, sizeof(x));
+        } else {
+            uint32_t x = (uint32_t)v;
+            e.put(ARG_U32, &x, sizeof(x));
+        }
+    } else if (std::is_signed<T>::value) {
+        int64_t x = (int64_t)v;
+        e.put(ARG_I64, &x, sizeof(x));
+    } else {
+        uint64_t x = (uint64_t)v;
+        e.put(ARG_U64, &x, sizeof(x));
+    }
+}
+
+inline void encode(Encoder& e, double v) { e.put(ARG_DOUBLE, &v, sizeof(v)); }
+inline void encode(Encoder& e, float v) { encode(e, (double)v); }
+inline void encode(Encoder& e, const char* s) { e.putString(s); }
+inline void encode(Encoder& e, char* s) { e.putString(s); }
+inline void encode(Encoder& e, const String& s) { e.putString(s.c_str()); }
+inline void encode(Encoder& e, const void* p) { e.put(ARG_PTR, &p, sizeof(p)); }
+
+inline void encodeAll(Encoder&) {}
+template <typename T, typename... Rest>
+inline void encodeAll(Encoder& e, const T& first, const Rest&... rest) {
+    encode(e, first);
+    encodeAll(e, rest...);
+}
+
+void commit(Encoder& e, uint8_t level, const char* fmt);
+
+} // namespace logdetail
+
+template <typename... Args>
+inline void logWrite(uint8_t level, const char* fmt, const Args&... args) {
+    logdetail::Encoder e;
+    logdetail::encodeAll(e, args...);
+    logdetail::commit(e, level, fmt);
+}
+
+#endif
@@ -0,0 +1,471 @@
+#include "low_power.h"
+#include "node_link.h"
+#include "logging/Logger.h"
+
+#if POWER_MODE == POWER_MODE_BATTERY
+#if NODE_ROLE != NODE_ROLE_STANDALONE
+#error "POWER_MODE_BATTERY chỉ hỗ trợ NODE_ROLE_STANDALONE (gateway phải thức để nhận ESP-NOW)"
+#endif
+
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <driver/gpio.h>
+#include <sys/time.h>
+#include "aws_config.h"
+#include "aws_mqtt.h"
+#include "ota_update.h"
+#include "power/SampleRing.h"
+#include "power/PowerBudget.h"
+#include "telemetry/TimeBase.h"
+
+#ifndef AWS_IOT_POWER_TOPIC
+#define AWS_IOT_POWER_TOPIC "esp32/power"
+#endif
+#define RESET_CLOCK_MAX_US (24LL * 3600 * 1000000) // reset khi đang thức: tin đồng hồ hệ thống trong khoảng này
+
+// ------------------ TRẠNG THÁI QUA DEEP SLEEP ------------------
+// RTC slow memory: giữ nguyên khi deep sleep và khi reset mềm (panic, watchdog, ESP.restart() sau OTA);
+// chỉ khởi tạo lại khi mất nguồn/sụt áp hoặc nội dung không hợp lệ (magic, layout đổi sau OTA)
+struct LowPowerState {
+    uint32_t magic;
+    uint32_t cycles;
+
+    // Đồng hồ bền: monotonicUs() về 0 mỗi lần thức; gettimeofday() vẫn chạy trong deep sleep
+    // (RTC timer) nên đo được thời gian ngủ thật, kể cả khi bị lửa đánh thức sớm
+    uint64_t clockAtSleepUs;
+    int64_t sysAtSleepUs;
+    uint32_t plannedSleepMs;
+
+    float temp;
+    float hum;
+    int gas;
+    int gasBase;               // mức nền MQ2 (0 = chưa hiệu chỉnh)
+    uint32_t lastGasCycle;
+    bool lastDanger;
+    uint32_t nextFlushCycle;
+
+    int32_t channel;           // 0 = chưa có, kết nối bằng scan
+    uint8_t bssid[6];
+
+    uint32_t lastWakeToPublishMs;
+    uint32_t maxWakeToPublishMs;
+    uint32_t flameWakes;
+    uint32_t flushes;
+    uint32_t flushFailures;
+
+    CycleTiming lastCycle;
+    PowerBudget budget;
+    SampleRing ring;
+};
+
+RTC_DATA_ATTR static LowPowerState state;
+static const uint32_t LOW_POWER_MAGIC = 0x4C504D31u ^ (uint32_t)sizeof(LowPowerState);
+
+static DHT11Sensor* dht = nullptr;
+static MQ2Sensor* mq2 = nullptr;
+static FlameSensor* flame = nullptr;
+
+static uint64_t bootClockUs = 0;   // đồng hồ bền tại lúc app khởi động
+static bool heaterWarm = false;    // heater đang bật và MQ2 đã qua warm-up
+static unsigned long lastDangerMs = 0;
+static uint64_t awakeSinceUs = 0;  // bắt đầu giai đoạn thức vì nguy hiểm
+static bool alarmQueued = false;   // alarm lúc thức đã vào làn alarm của aws_mqtt, chờ loop() gửi
+static unsigned long alarmLatencyBeforeUs = 0;
+
+static uint64_t clockNowUs() { return bootClockUs + monotonicUs(); }
+static uint32_t clockNowMs() { return (uint32_t)(clockNowUs() / 1000); }
+
+static int64_t systemUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// fromSleep = false: reset mềm lúc đang thức (không biết đã ngủ bao lâu), chỉ nối lại đồng hồ,
+// không cộng vào ngân sách pin
+static void restoreClock(bool fromSleep) {
+    int64_t sleptUs = systemUs() - state.sysAtSleepUs;
+    int64_t plannedUs = (int64_t)state.plannedSleepMs * 1000;
+    int64_t maxUs = fromSleep ? plannedUs + 60000000 : RESET_CLOCK_MAX_US;
+    if (sleptUs < 0 || sleptUs > maxUs) sleptUs = plannedUs; // đồng hồ hệ thống bị chỉnh
+
+    bootClockUs = state.clockAtSleepUs + sleptUs - monotonicUs();
+    if (fromSleep) state.budget.addSleep(sleptUs / 1000, MQ2_HEATER_PIN < 0);
+}
+
+// ------------------ CẢM BIẾN ------------------
+static void setHeater(bool on) {
+#if MQ2_HEATER_PIN >= 0
+    gpio_hold_dis((gpio_num_t)MQ2_HEATER_PIN);
+    pinMode(MQ2_HEATER_PIN, OUTPUT);
+    digitalWrite(MQ2_HEATER_PIN, on ? HIGH : LOW);
+#else
+    (void)on;
+#endif
+}
+
+static bool confirmFlame() {
+    flame->begin();
+    if (digitalRead(flame->getPin()) == HIGH) return false; // không có tín hiệu, khỏi chờ lọc nhiễu
+
+    unsigned long start = millis();
+    bool stable = false;
+    while (millis() - start <= BATTERY_FLAME_CONFIRM_MS) {
+        stable = flame->isStableFlame();
+        delay(5);
+    }
+    return stable;
+}
+
+// Light sleep: CPU dừng (~1 mA thay vì ~40 mA), GPIO giữ nguyên nên heater vẫn nóng.
+// Lửa vẫn đánh thức được; trả về true nếu thức vì lửa.
+static bool lightSleep(uint32_t ms, CycleTiming& t) {
+    uint64_t start = monotonicUs();
+    logFlush();
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)flame->getPin(), 0);
+    esp_light_sleep_start();
+    bool byFlame = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0;
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    t.lightSleepMs += (monotonicUs() - start) / 1000;
+    return byFlame;
+}
+
+// Đo gas: bật heater, chờ warm-up ở light sleep, rồi đọc như chế độ thường (3 lần vượt ngưỡng liên tiếp).
+// Heater nguội cho giá trị sai, nên không đọc trước khi hết warm-up; lửa xuất hiện giữa chừng → bỏ mẫu.
+static bool sampleGas(bool coldBoot, CycleTiming& t, bool& flameNow) {
+    uint64_t heaterOnUs = monotonicUs();
+    setHeater(true);
+    mq2->begin();
+    mq2->setWarmup(MQ2_HEATER_PIN >= 0 || coldBoot ? BATTERY_MQ2_WARMUP_MS : 0);
+    if (state.gasBase > 0) mq2->setBaseLevel(state.gasBase);
+    mq2->update();
+
+    while (!mq2->isReady()) {
+        uint32_t elapsedMs = (monotonicUs() - heaterOnUs) / 1000;
+        uint32_t leftMs = elapsedMs < BATTERY_MQ2_WARMUP_MS ? BATTERY_MQ2_WARMUP_MS - elapsedMs : 1;
+        if (lightSleep(leftMs, t) && confirmFlame()) {
+            flameNow = true;
+            state.flameWakes++;
+            break;
+        }
+        mq2->update(); // hết warm-up: hiệu chỉnh nếu chưa có mức nền (không khí sạch lúc lắp đặt)
+    }
+
+    bool danger = false;
+    if (mq2->isReady()) {
+        if (state.gasBase == 0) state.gasBase = mq2->getBaseLevel();
+        for (int i = 0; i < 3; i++) danger = mq2->isDanger();
+        state.gas = mq2->getRaw();
+        state.lastGasCycle = state.cycles;
+    }
+
+    heaterWarm = mq2->isReady() && (danger || flameNow);
+    if (!heaterWarm) setHeater(false); // nguy hiểm: giữ heater để loop() tiếp tục theo dõi
+    t.heaterMs += (monotonicUs() - heaterOnUs) / 1000;
+    return danger;
+}
+
+// ------------------ GỬI ------------------
+static bool connectUplink() {
+    uint64_t start = monotonicUs();
+    uint64_t timeoutUs = (uint64_t)BATTERY_CONNECT_TIMEOUT_MS * 1000;
+
+    // BSSID + kênh của lần trước: bỏ qua scan (~1-2 s radio)
+    WiFi.mode(WIFI_STA);
+    bool fast = state.channel > 0;
+    if (fast) WiFi.begin(WIFI_SSID, WIFI_PASSWORD, state.channel, state.bssid);
+    else WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+
+    while (WiFi.status() != WL_CONNECTED) {
+        uint64_t elapsed = monotonicUs() - start;
+        if (elapsed >= timeoutUs) {
+            state.channel = 0;
+            return false;
+        }
+        if (fast && elapsed >= (uint64_t)BATTERY_FAST_CONNECT_MS * 1000) {
+            LOG_W("[PWR] Fast connect failed, scanning");
+            fast = false;
+            WiFi.disconnect();
+            WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+        }
+        delay(10);
+    }
+    state.channel = WiFi.channel();
+    memcpy(state.bssid, WiFi.BSSID(), sizeof(state.bssid));
+
+    // Giờ hệ thống còn nguyên sau deep sleep nên TLS không phải chờ SNTP (trừ lần cấp nguồn đầu)
+    while (!isAWSConnected()) {
+        if (monotonicUs() - start >= timeoutUs) return false;
+        loopAWS();
+        delay(10);
+    }
+    return true;
+}
+
+// Số liệu thời gian là của chu kỳ trước (chu kỳ hiện tại chưa kết thúc)
+static void publishPowerStatus() {
+    StaticJsonDocument<384> doc;
+    doc["deviceId"] = AWS_IOT_CLIENT_ID;
+    doc["cycles"] = state.cycles;
+    doc["avgMa"] = state.budget.averageMa();
+    doc["cycleMa"] = PowerBudget::cycleMa(state.lastCycle);
+    doc["batteryDays"] = state.budget.batteryDays(BATTERY_CAPACITY_MAH);
+    doc["activeMs"] = state.lastCycle.activeMs;
+    doc["radioMs"] = state.lastCycle.radioMs;
+    doc["lightSleepMs"] = state.lastCycle.lightSleepMs;
+    doc["heaterMs"] = state.lastCycle.heaterMs;
+    doc["wakeToPublishMs"] = state.lastWakeToPublishMs; // từ lúc app chạy, chưa gồm ~POWER_BOOT_MS
+    doc["maxWakeToPublishMs"] = state.maxWakeToPublishMs;
+    doc["flameWakes"] = state.flameWakes;
+    doc["buffered"] = state.ring.size();
+    doc["overwrites"] = state.ring.overwrites;
+    doc["alarmOverwrites"] = state.ring.alarmOverwrites;
+    doc["flushFailures"] = state.flushFailures;
+
+    char payload[384];
+    serializeJson(doc, payload, sizeof(payload));
+    publishMessage(AWS_IOT_POWER_TOPIC, payload);
+}
+
+// Lệnh trên esp32/sub chỉ đến khi client.loop() chạy: nghe thêm một khoảng ngắn sau khi gửi.
+// Lệnh gửi lúc thiết bị ngủ bị broker bỏ qua, trừ khi là message retained. Lệnh OTA thì dừng nghe ngay
+static void pollCommands() {
+    uint64_t start = monotonicUs();
+    while (!isOTAActive() && monotonicUs() - start < (uint64_t)BATTERY_COMMAND_WINDOW_MS * 1000) {
+        loopAWS();
+        delay(10);
+    }
+}
+
+// Alarm gửi trước (độ trễ thức → publish), sau đó xả buffer RTC từ cũ đến mới.
+// Bản ghi chỉ bị xóa khỏi buffer sau khi publish thành công.
+static bool flushRecords(const SensorData* alarm, CycleTiming& t) {
+    uint64_t start = monotonicUs();
+    bool ok = connectUplink();
+
+    if (alarm) {
+        if (ok && publishSensorRecord(*alarm)) {
+            state.lastWakeToPublishMs = monotonicUs() / 1000;
+            if (state.lastWakeToPublishMs > state.maxWakeToPublishMs)
+                state.maxWakeToPublishMs = state.lastWakeToPublishMs;
+            LOG_I("[PWR] Alarm published %lu ms after wake", (unsigned long)state.lastWakeToPublishMs);
+        } else {
+            ok = false;
+            state.ring.push(*alarm, clockNowMs()); // giữ priority alarm, gửi ở lần kết nối sau
+        }
+    }
+
+    SensorData data;
+    while (ok && state.ring.peek(data, clockNowMs(), monotonicUs())) {
+        if (!publishSensorRecord(data)) {
+            ok = false;
+            break;
+        }
+        state.ring.drop();
+    }
+    if (isAWSConnected()) pollCommands();
+
+    t.radioMs += (monotonicUs() - start) / 1000;
+    if (ok) {
+        state.flushes++;
+        publishPowerStatus();
+    } else {
+        state.flushFailures++;
+        state.nextFlushCycle = state.cycles + BATTERY_RETRY_CYCLES;
+        LOG_W("[PWR] Flush failed, %u records buffered", state.ring.size());
+    }
+    return ok;
+}
+
+// ------------------ NGỦ ------------------
+static void enterDeepSleep() {
+    disconnectAWS();
+    delay(20); // để lwIP gửi nốt DISCONNECT/FIN trước khi tắt radio
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+
+    setHeater(false);
+#if MQ2_HEATER_PIN >= 0
+    gpio_hold_en((gpio_num_t)MQ2_HEATER_PIN); // giữ mức LOW trong deep sleep
+    gpio_deep_sleep_hold_en();
+#endif
+
+    // Giữ nhịp BATTERY_SAMPLE_MS tính từ lúc thức
+    uint32_t awakeMs = millis();
+    uint32_t sleepMs = awakeMs + BATTERY_MIN_SLEEP_MS < BATTERY_SAMPLE_MS ? BATTERY_SAMPLE_MS - awakeMs
+                                                                           : BATTERY_MIN_SLEEP_MS;
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000);
+    // Lửa vẫn còn thì chỉ dùng timer, tránh bị đánh thức liên tục
+    if (digitalRead(flame->getPin()) == HIGH) esp_sleep_enable_ext0_wakeup((gpio_num_t)flame->getPin(), 0);
+
+    state.plannedSleepMs = sleepMs;
+    state.clockAtSleepUs = clockNowUs();
+    state.sysAtSleepUs = systemUs();
+
+    LOG_I("[PWR] Sleeping %lu ms (awake %lu ms, %u buffered)", (unsigned long)sleepMs,
+          (unsigned long)awakeMs, state.ring.size());
+    logFlush();
+    esp_deep_sleep_start();
+}
+
+// ------------------ API ------------------
+void initLowPower(DHT11Sensor* d, MQ2Sensor* m, FlameSensor* f) {
+    dht = d;
+    mq2 = m;
+    flame = f;
+}
+
+bool runLowPowerCycle() {
+    CycleTiming t = {};
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    esp_reset_reason_t reset = esp_reset_reason();
+    // Chỉ mất nguồn mới là khởi động lạnh (hiệu chỉnh gas, gửi xác nhận cấu hình). Reset mềm giữ buffer
+    // chưa gửi và mức nền gas: không khí lúc panic/watchdog chưa chắc sạch để hiệu chỉnh lại
+    bool coldBoot = reset == ESP_RST_POWERON || reset == ESP_RST_BROWNOUT ||
+                    state.magic != LOW_POWER_MAGIC || !state.ring.valid();
+
+    if (coldBoot) {
+        memset(&state, 0, sizeof(state));
+        state.magic = LOW_POWER_MAGIC;
+        state.ring.clear();
+        state.budget.clear();
+        bootClockUs = 0;
+    } else {
+        if (cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+            LOG_W("[PWR] Reset (reason %d), keeping %u buffered records", (int)reset, state.ring.size());
+        }
+        restoreClock(cause != ESP_SLEEP_WAKEUP_UNDEFINED);
+    }
+    state.cycles++;
+
+    // --- Đo ---
+    bool flameNow = confirmFlame();
+    if (flameNow && cause == ESP_SLEEP_WAKEUP_EXT0) state.flameWakes++;
+
+    dht->begin();
+    if (dht->readNow()) {
+        state.temp = dht->readTemperature();
+        state.hum = dht->readHumidity();
+    }
+
+    bool gasDanger = false;
+    bool gasDue = MQ2_HEATER_PIN < 0 || coldBoot || state.lastDanger ||
+                  state.cycles - state.lastGasCycle >= BATTERY_GAS_EVERY;
+    if (gasDue && !flameNow) gasDanger = sampleGas(coldBoot, t, flameNow);
+
+    // Chu kỳ đo chạy trọn không crash = image tự kiểm tra xong: xác nhận ngay lần thức đầu tiên sau OTA,
+    // không chờ lần kết nối (có thể cách nhiều chu kỳ; bootloader rollback nếu image chưa được xác nhận)
+    confirmOTA();
+
+    bool danger = flameNow || gasDanger;
+    DataPriority priority = danger != state.lastDanger ? PRIORITY_ALARM : PRIORITY_ROUTINE;
+    SensorData data = {state.temp, state.hum, state.gas, flameNow, danger, priority, monotonicUs()};
+    state.lastDanger = danger;
+
+    // --- Gửi: alarm ngay; dữ liệu thường theo lô. Lần cấp nguồn đầu gửi luôn để xác nhận cấu hình ---
+    // Nguy hiểm: không kết nối ở đây (tới 15 s) mà trả về ngay để setup() bật còi/LED trước;
+    // alarm vào làn ưu tiên của aws_mqtt, loop() gửi ngay khi có kết nối, buffer RTC xả sau đó
+    if (danger) {
+        if (priority == PRIORITY_ALARM) {
+            alarmLatencyBeforeUs = getLastAlarmLatencyUs();
+            sendSensorData(data.temp, data.hum, data.gas, data.flame, data.danger, PRIORITY_ALARM);
+            alarmQueued = true;
+        } else {
+            state.ring.push(data, clockNowMs());
+        }
+    } else if (priority == PRIORITY_ALARM) {
+        flushRecords(&data, t);
+    } else {
+        state.ring.push(data, clockNowMs());
+        if (coldBoot || (state.ring.size() >= BATTERY_BATCH_RECORDS && state.cycles >= state.nextFlushCycle))
+            flushRecords(nullptr, t);
+    }
+
+    uint32_t awakeMs = monotonicUs() / 1000;
+    t.activeMs = awakeMs > t.radioMs + t.lightSleepMs ? awakeMs - t.radioMs - t.lightSleepMs : 0;
+    t.sleepMs = BATTERY_SAMPLE_MS > awakeMs ? BATTERY_SAMPLE_MS - awakeMs : BATTERY_MIN_SLEEP_MS;
+    CycleTiming awake = t;
+    if (MQ2_HEATER_PIN < 0) { // heater không cắt: nóng suốt chu kỳ (phần ngủ cộng lúc thức dậy)
+        awake.heaterMs = awakeMs;
+        t.heaterMs = awakeMs + t.sleepMs;
+    }
+    state.lastCycle = t;
+    state.budget.addAwake(awake, true);
+
+    LOG_I("[PWR] cycle=%lu active=%lu radio=%lu light=%lu heater=%lu ms | cycle %.2f mA, avg %.2f mA (~%.0f days)",
+          (unsigned long)state.cycles, (unsigned long)t.activeMs, (unsigned long)t.radioMs,
+          (unsigned long)t.lightSleepMs, (unsigned long)t.heaterMs, PowerBudget::cycleMa(t),
+          state.budget.averageMa(), state.budget.batteryDays(BATTERY_CAPACITY_MAH));
+
+    if (!danger && !isOTAActive()) enterDeepSleep();
+
+    // Nguy hiểm: ở lại thức, setup()/loop() chạy còi, LED, OLED và gửi định kỳ như chế độ thường.
+    // OTA: ở lại thức để loopOTA() tải xong rồi khởi động lại vào image mới
+    if (danger) LOG_W("[PWR] Danger detected, staying awake");
+    else LOG_I("[PWR] OTA started, staying awake");
+    awakeSinceUs = monotonicUs();
+    lastDangerMs = millis();
+    return danger;
+}
+
+bool resumeLowPower() {
+    setHeater(true);
+    if (state.gasBase > 0) mq2->setBaseLevel(state.gasBase);
+    if (heaterWarm) mq2->setWarmup(0);
+    else if (MQ2_HEATER_PIN >= 0) mq2->setWarmup(BATTERY_MQ2_WARMUP_MS);
+    mq2->update(); // heater đã nóng → sẵn sàng ngay, updateAlerts() trong setup() đọc được gas
+    return state.lastDanger;
+}
+
+void loopLowPower(bool danger) {
+    // Alarm lúc thức vừa được publish (latency của aws_mqtt đổi): ghi độ trễ thức → publish
+    if (alarmQueued && getLastAlarmLatencyUs() != alarmLatencyBeforeUs) {
+        alarmQueued = false;
+        state.lastWakeToPublishMs = millis();
+        if (state.lastWakeToPublishMs > state.maxWakeToPublishMs)
+            state.maxWakeToPublishMs = state.lastWakeToPublishMs;
+        LOG_I("[PWR] Alarm published %lu ms after wake", (unsigned long)state.lastWakeToPublishMs);
+    }
+
+    // Xả dần buffer RTC khi có mạng, mỗi lượt một bản ghi để không chặn vòng cảm biến
+    SensorData record;
+    if (!alarmQueued && isAWSConnected() && state.ring.peek(record, clockNowMs(), monotonicUs()) &&
+        publishSensorRecord(record)) {
+        state.ring.drop();
+    }
+
+    state.lastDanger = danger;
+    if (danger || isOTAActive()) {
+        lastDangerMs = millis();
+        return;
+    }
+
+    unsigned long calm = millis() - lastDangerMs;
+    if (calm < BATTERY_CALM_MS) return;
+    bool unsent = pendingTelemetry() > 0 || state.ring.size() > 0;
+    if (unsent && calm < 2 * BATTERY_CALM_MS) return; // chờ gửi nốt, có giới hạn
+
+    // Giai đoạn thức vì nguy hiểm/OTA: WiFi và heater bật suốt
+    CycleTiming t = {};
+    t.radioMs = (monotonicUs() - awakeSinceUs) / 1000;
+    t.heaterMs = t.radioMs;
+    state.budget.addAwake(t, false);
+    LOG_I("[PWR] Awake period over, back to sleep");
+    enterDeepSleep();
+}
+
+#else
+
+void initLowPower(DHT11Sensor* dht, MQ2Sensor* mq2, FlameSensor* flame) {
+    (void)dht;
+    (void)mq2;
+    (void)flame;
+}
+bool runLowPowerCycle() { return false; }
+bool resumeLowPower() { return false; }
+void loopLowPower(bool danger) { (void)danger; }
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+#include <Arduino.h>
+#include "sensors/DHT11Sensor.h"
+#include "sensors/MQ2Sensor.h"
+#include "sensors/FlameSensor.h"
+
+// Chế độ nguồn, chọn lúc build: build_flags = -DPOWER_MODE=POWER_MODE_BATTERY
+#define POWER_MODE_ALWAYS_ON 0 // vòng loop() liên tục, WiFi luôn bật (mặc định)
+#define POWER_MODE_BATTERY   1 // deep sleep giữa các lần đo, đệm RTC, WiFi chỉ bật khi gửi
+
+#ifndef POWER_MODE
+#define POWER_MODE POWER_MODE_ALWAYS_ON
+#endif
+
+// MOSFET cắt heater MQ2 (-1 = heater nối thẳng nguồn, luôn nóng nhưng tốn ~150 mA liên tục)
+#ifndef MQ2_HEATER_PIN
+#define MQ2_HEATER_PIN -1
+#endif
+
+#define BATTERY_SAMPLE_MS 30000        // chu kỳ đo (thức → ngủ → thức)
+#define BATTERY_MIN_SLEEP_MS 1000
+#define BATTERY_BATCH_RECORDS 10       // bật WiFi khi buffer RTC có đủ số bản ghi này
+#define BATTERY_RETRY_CYCLES 4         // gửi lỗi: bỏ qua vài chu kỳ rồi mới thử lại (alarm thì gửi ngay)
+#define BATTERY_GAS_EVERY 10           // đo gas mỗi N chu kỳ khi heater được cắt
+#define BATTERY_MQ2_WARMUP_MS 20000    // heater nguội → đọc ổn định
+#define BATTERY_FLAME_CONFIRM_MS 150   // lọc nhiễu trước khi coi lần thức do lửa là thật
+#define BATTERY_CONNECT_TIMEOUT_MS 15000
+#define BATTERY_FAST_CONNECT_MS 3000   // kết nối theo BSSID/kênh đã lưu, quá giờ thì scan lại
+#define BATTERY_COMMAND_WINDOW_MS 300 // sau mỗi lần gửi: đọc lệnh trên esp32/sub trước khi ngủ
+#define BATTERY_CALM_MS 60000          // hết nguy hiểm bao lâu thì quay lại ngủ
+#define BATTERY_CAPACITY_MAH 2500.0f   // cho ước lượng số ngày pin
+
+void initLowPower(DHT11Sensor* dht, MQ2Sensor* mq2, FlameSensor* flame);
+
+// Gọi đầu setup(). Chế độ pin: đo → đệm RTC → gửi nếu cần → deep sleep, không trả về;
+// chỉ trả về (true) khi phát hiện nguy hiểm, chưa kết nối mạng: setup() bật còi/LED trước,
+// alarm đã nằm trong làn ưu tiên của aws_mqtt và được gửi từ loop(). Lệnh OTA nhận được lúc gửi
+// cũng giữ thiết bị thức (trả về false) để loop() tải firmware. Chế độ thường: trả về false.
+bool runLowPowerCycle();
+
+// Gọi trong setup() sau mq2.begin(): khôi phục mức nền MQ2 và heater. Trả về true nếu đang nguy hiểm.
+bool resumeLowPower();
+
+// Gọi cuối loop(): xả dần buffer RTC; hết nguy hiểm (và không còn OTA đang tải) đủ BATTERY_CALM_MS
+// và đã gửi xong thì quay lại deep sleep
+void loopLowPower(bool danger);
+
+#endif
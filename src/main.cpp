@@ -2,11 +2,18 @@
 #include "sensors/DHT11Sensor.h"
 #include "sensors/MQ2Sensor.h"
 #include "sensors/FlameSensor.h"
+#include "sensors/Smoothing.h"
 #include "actuators/LEDController.h"
 #include "actuators/Buzzer.h"
 #include "display/OLEDDisplay.h"
 #include "Alerts.h"
 #include "aws_mqtt.h" 
+#include "logging/Logger.h"
+#include "ota_update.h"
+#include "local/LiveServer.h"
+#include "history.h"
+#include "node_link.h"
+#include "low_power.h"
 
 // ------------------ MODULE KHAI BÁO ------------------
 DHT11Sensor dht(4);
@@ -25,7 +32,12 @@ const unsigned long ALERT_INTERVAL = 5000; // 5 giây giữa các cảnh báo kh
 #define OLED_INTERVAL 1000
 #define DEBUG_INTERVAL 10000
 
-unsigned long lastDHT = 0, lastMQ2 = 0, lastOLED = 0, lastDebug = 0;
+// Trang OLED: xen kẽ số liệu hiện tại và biểu đồ 2 giờ gần nhất (không hiện biểu đồ khi nguy hiểm)
+#define OLED_LIVE_PAGE_MS 8000
+#define OLED_TREND_PAGE_MS 4000
+#define TREND_POINTS 120
+
+unsigned long lastDHT = 0, lastMQ2 = 0, lastOLED = 0, lastDebug = 0, lastHistory = 0;
 
 float temp = 0, hum = 0;
 int gas = 0;
@@ -35,23 +47,52 @@ bool flameDetected = false;
 float tempSmooth = 0, humSmooth = 0, gasSmooth = 0;
 const float alpha = 0.2; // hệ số lọc trung bình động
 
+// --- Trang biểu đồ, mỗi lượt đổi một kênh: nhiệt độ → độ ẩm → gas ---
+static bool showTrendPage(unsigned long now, bool danger)
+{
+  static const char *labels[] = {"Temp", "Hum", "Gas"};
+  static const char *units[] = {"C", "%", ""};
+  static float trend[TREND_POINTS];
+
+  const unsigned long cycle = OLED_LIVE_PAGE_MS + OLED_TREND_PAGE_MS;
+  if (danger || now % cycle < OLED_LIVE_PAGE_MS) return false;
+
+  uint8_t channel = (now / cycle) % 3;
+  size_t n = historyLatest((HistoryChannel)channel, trend, TREND_POINTS);
+  if (n < 2) return false; // chưa đủ dữ liệu
+
+  oled.showTrend(labels[channel], units[channel], trend, n);
+  return true;
+}
+
 // =====================================================
 void setup()
 {
   Serial.begin(115200);
-  Serial.println("Smart Home Monitor Starting...");
+  logBegin(); // log ghi vào ring buffer, task riêng xuất ra UART
+  LOG_I("Smart Home Monitor Starting...");
 
-  connectAWS();
+  initOTA(); // xác nhận hoặc rollback nếu vừa cập nhật firmware
+  initLowPower(&dht, &mq2, &flame);
+  // chế độ pin: đo, đệm RTC rồi ngủ sâu; chỉ chạy tiếp khi có nguy hiểm (dangerWake)
+  bool dangerWake = runLowPowerCycle();
 
+  // --- Cảm biến & cảnh báo trước mọi việc mạng: thức vì nguy hiểm thì còi/LED phải chạy ngay ---
   dht.begin();
-  delay(2000); // chờ DHT11 ổn định 2 giây
   oled.begin();
   flame.begin();
-  flame.isStableFlame(); // đọc 1 lần đầu để khởi động trạng thái ổn định
+  flameDetected = flame.isStableFlame(); // đọc 1 lần đầu để khởi động trạng thái ổn định
   mq2.begin();
+  lastDangerState = resumeLowPower(); // chế độ pin: alarm đã vào làn ưu tiên, không gửi lặp
+  bool gasDanger = dangerWake && mq2.isDanger(); // đánh giá 1 lần; khởi động thường MQ2 còn warm-up
+  initAlerts(&leds, &buzzer);
+  if (dangerWake) updateAlerts(gasDanger, flameDetected);
 
-  // --- Cảnh báo ---
-  initAlerts(&leds, &buzzer, &mq2, &flame);
+  initNodeLink(); // gateway/leaf ESP-NOW, không làm gì ở chế độ standalone
+#if NODE_ROLE != NODE_ROLE_LEAF
+  connectAWS();
+#endif
+  if (!dangerWake) delay(2000); // chờ DHT11 ổn định 2 giây (thức vì nguy hiểm: DHT vừa đọc xong)
 
   // --- Đọc giá trị ban đầu ---
   temp = dht.readTemperature();
@@ -63,9 +104,9 @@ void setup()
   humSmooth = hum;
   gasSmooth = gas;
 
-  oled.updateData(tempSmooth, humSmooth, (int)gasSmooth, mq2.isDanger(), flameDetected);
+  oled.updateData(tempSmooth, humSmooth, (int)gasSmooth, gasDanger, flameDetected);
 
-  Serial.println("System ready.\n");
+  LOG_I("System ready.\n");
 }
 
 // =====================================================
@@ -73,7 +114,12 @@ void loop()
 {
   unsigned long now = millis();
 
+#if NODE_ROLE != NODE_ROLE_LEAF
   loopAWS();
+#endif
+  loopNodeLink();
+  loopLiveServer(); // xem trực tiếp trong LAN, vẫn chạy khi mất internet
+  loopHistory();    // trả lời truy vấn lịch sử, mỗi lượt một block
 
   mq2.update(); // cập nhật trạng thái MQ2 (non-blocking)
 
@@ -93,43 +139,60 @@ void loop()
   }
 
   // --- smoothing ---
-  tempSmooth = alpha * temp + (1 - alpha) * tempSmooth;
-  humSmooth = alpha * hum + (1 - alpha) * humSmooth;
-  gasSmooth = alpha * gas + (1 - alpha) * gasSmooth;
+  tempSmooth = emaUpdate(tempSmooth, temp, alpha);
+  humSmooth = emaUpdate(humSmooth, hum, alpha);
+  gasSmooth = emaUpdate(gasSmooth, gas, alpha);
+
+  // --- đánh giá nguy hiểm đúng 1 lần mỗi vòng (isDanger() đẩy bộ đếm trễ của MQ2) ---
+  bool gasDanger = mq2.isDanger();
+  bool dangerNow = gasDanger || flameDetected;
 
   // --- cập nhật OLED mỗi 1 giây ---
   if (now - lastOLED >= OLED_INTERVAL)
   {
-    oled.updateData(tempSmooth, humSmooth, (int)gasSmooth, mq2.isDanger(), flameDetected);
+    if (!showTrendPage(now, dangerNow))
+      oled.updateData(tempSmooth, humSmooth, (int)gasSmooth, gasDanger, flameDetected);
+    publishLive(tempSmooth, humSmooth, (int)gasSmooth, flameDetected, dangerNow);
     lastOLED = now;
   }
 
+  // --- lưu lịch sử nén mỗi phút ---
+  if (now - lastHistory >= HISTORY_INTERVAL_MS)
+  {
+    recordHistory(tempSmooth, humSmooth, (int)gasSmooth);
+    lastHistory = now;
+  }
+
   // --- cập nhật LED & Buzzer ---
-  updateAlerts();
+  updateAlerts(gasDanger, flameDetected);
 
   // --- GỬI THÔNG TIN ĐỊNH KỲ HOẶC KHI PHÁT HIỆN NGUY HIỂM ---
-  bool dangerNow = mq2.isDanger() || flameDetected; // mới
+  bool dangerChanged = dangerNow != lastDangerState;  // bắt đầu hoặc hết nguy hiểm
 
-  if ((dangerNow && !lastDangerState) ||                      // mới phát hiện nguy hiểm
+  if (dangerChanged ||                                        // chuyển trạng thái → gửi ưu tiên
       (dangerNow && now - lastAlertTime >= ALERT_INTERVAL) || // vẫn nguy hiểm → log mỗi 5s
       (!dangerNow && now - lastAlertTime >= DEBUG_INTERVAL))
   {
-    if (mq2.isDanger() || flameDetected)
+    // Sự kiện chuyển trạng thái đi làn ưu tiên, gửi trước khi ghi log
+    if (dangerChanged)
+    {
+      reportSensorData(tempSmooth, humSmooth, (int)gasSmooth, flameDetected, dangerNow, PRIORITY_ALARM);
+      publishLive(tempSmooth, humSmooth, (int)gasSmooth, flameDetected, dangerNow);
+    }
+
+    if (dangerNow)
     {
-      Serial.println("  ALERT! Danger detected!");
+      LOG_W("  ALERT! Danger detected!");
     }
 
-    Serial.print("Temp: ");
-    Serial.print(tempSmooth);
-    Serial.print(" C | Hum: ");
-    Serial.print(humSmooth);
-    Serial.print(" % | Gas: ");
-    Serial.print(gasSmooth);
-    Serial.print(" | Flame: ");
-    Serial.println(flameDetected ? "YES" : "NO");
+    LOG_I("Temp: %.2f C | Hum: %.2f %% | Gas: %.2f | Flame: %s",
+          tempSmooth, humSmooth, gasSmooth, flameDetected ? "YES" : "NO");
 
     // **PUBLISH ĐẾN AWS CHỈ KHI ĐÃ ĐƯỢC GIỚI HẠN**
-    sendSensorData(tempSmooth, humSmooth, (int)gasSmooth, flameDetected, dangerNow);
+    if (!dangerChanged)
+    {
+      reportSensorData(tempSmooth, humSmooth, (int)gasSmooth, flameDetected, dangerNow);
+    }
 
 
     // 🔧 Quan trọng: cập nhật 2 biến trạng thái
@@ -139,5 +202,11 @@ void loop()
     lastDebug = now; // reset thời gian để không bị spam
   }
 
+  // --- OTA: tải từng phần, không chặn vòng cảm biến ---
+  loopOTA(dangerNow);
+
+  // --- Chế độ pin: hết nguy hiểm thì quay lại deep sleep ---
+  loopLowPower(dangerNow);
+
   // --- Không delay() để CPU luôn rảnh rỗi ---
 }
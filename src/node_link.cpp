@@ -0,0 +1,122 @@
+#include "node_link.h"
+#include "aws_mqtt.h"
+#include "logging/Logger.h"
+
+#if NODE_ROLE != NODE_ROLE_STANDALONE
+#include "aws_config.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include "gateway/EspNowTransport.h"
+#include "telemetry/TimeBase.h"
+static EspNowTransport link;
+#endif
+
+#if NODE_ROLE == NODE_ROLE_GATEWAY
+#include "gateway/Gateway.h"
+
+#ifndef AWS_IOT_GATEWAY_TOPIC
+#define AWS_IOT_GATEWAY_TOPIC "esp32/gateway"
+#endif
+#define GATEWAY_REPORT_MS 60000
+
+static bool publishBatch(const char* payload, size_t len, void* ctx) {
+    (void)len;
+    (void)ctx;
+    return publishMessage(AWS_IOT_GATEWAY_TOPIC, payload);
+}
+
+static Gateway gateway(link, AWS_IOT_CLIENT_ID, publishBatch);
+static unsigned long lastReport = 0;
+
+// GATEWAY_LEAF_MACS: "aa:bb:cc:dd:ee:ff,..." (leaf in MAC của nó lúc khởi động)
+static uint16_t registerLeaves() {
+    uint16_t n = 0;
+    const char* p = GATEWAY_LEAF_MACS;
+    while (*p) {
+        unsigned int b[6];
+        int used = 0;
+        if (sscanf(p, "%x:%x:%x:%x:%x:%x%n", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &used) != 6) {
+            LOG_E("[GW] Bad MAC in GATEWAY_LEAF_MACS: %s", p);
+            break;
+        }
+        uint8_t mac[6];
+        for (int i = 0; i < 6; i++) mac[i] = (uint8_t)b[i];
+        if (gateway.allowLeaf(mac)) n++;
+        else LOG_E("[GW] Too many leaves, max %d", GATEWAY_MAX_NODES);
+        p += used;
+        while (*p == ',' || *p == ' ') p++;
+    }
+    return n;
+}
+
+void initNodeLink() {
+    WiFi.mode(WIFI_STA);
+    WiFi.setSleep(false); // modem sleep làm rơi frame ESP-NOW
+    uint16_t leaves = registerLeaves();
+    if (leaves == 0) LOG_E("[GW] No leaf registered (GATEWAY_LEAF_MACS), all leaf frames are rejected");
+    if (gateway.begin()) LOG_I("[GW] ESP-NOW gateway ready, %u leaves registered", leaves);
+    else LOG_E("[GW] ESP-NOW init failed");
+}
+
+void loopNodeLink() {
+    gateway.loop();
+
+    if (millis() - lastReport >= GATEWAY_REPORT_MS) {
+        const GatewayStats& s = gateway.stats();
+        LOG_I("[GW] nodes=%u frames=%lu dup=%lu lost=%lu reboots=%lu rejected=%lu batches=%lu records=%lu "
+              "fail=%lu alarmDrop=%lu rxOverflow=%lu",
+              gateway.nodeCount(), s.frames, s.duplicates, s.lost, s.reboots, s.rejected, s.batches, s.records,
+              s.uplinkFailures, s.droppedAlarms, link.getOverflows());
+        lastReport = millis();
+    }
+}
+
+#elif NODE_ROLE == NODE_ROLE_LEAF
+#include "gateway/LeafNode.h"
+
+static LeafNode* leaf = nullptr;
+
+// Leaf không kết nối router, nhưng phải phát trên đúng kênh gateway đang dùng
+static int32_t findRouterChannel() {
+    int n = WiFi.scanNetworks();
+    for (int i = 0; i < n; i++) {
+        if (WiFi.SSID(i) == WIFI_SSID) return WiFi.channel(i);
+    }
+    return 1;
+}
+
+void initNodeLink() {
+    WiFi.mode(WIFI_STA);
+    WiFi.disconnect();
+    int32_t channel = findRouterChannel();
+    esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    uint32_t nodeId = nodeIdFromAddress(mac); // gateway kiểm tra ID khớp MAC nguồn
+    static LeafNode node(link, nodeId, (uint8_t)(esp_random() % 255 + 1));
+    leaf = &node;
+
+    // MAC này phải có trong GATEWAY_LEAF_MACS của gateway
+    if (link.begin()) LOG_I("[LEAF] Node %08lx (MAC %02x:%02x:%02x:%02x:%02x:%02x) on channel %ld",
+                            (unsigned long)nodeId, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], (long)channel);
+    else LOG_E("[LEAF] ESP-NOW init failed");
+}
+
+void loopNodeLink() {}
+
+#else
+
+void initNodeLink() {}
+void loopNodeLink() {}
+
+#endif
+
+void reportSensorData(float temp, float hum, int gas, bool flame, bool danger, DataPriority priority) {
+#if NODE_ROLE == NODE_ROLE_LEAF
+    SensorData data = {temp, hum, gas, flame, danger, priority, monotonicUs()};
+    if (leaf && !leaf->send(data)) LOG_W("[LEAF] Send failed");
+#else
+    sendSensorData(temp, hum, gas, flame, danger, priority);
+#endif
+}
@@ -0,0 +1,29 @@
+#ifndef NODE_LINK_H
+#define NODE_LINK_H
+
+#include <Arduino.h>
+#include "telemetry/SensorData.h"
+
+// Vai trò thiết bị, chọn lúc build: build_flags = -DNODE_ROLE=NODE_ROLE_LEAF
+#define NODE_ROLE_STANDALONE 0 // tự kết nối AWS IoT (mặc định)
+#define NODE_ROLE_GATEWAY    1 // kết nối AWS + gom dữ liệu các leaf qua ESP-NOW, gửi theo lô
+#define NODE_ROLE_LEAF       2 // không TLS/AWS, gửi SensorData qua ESP-NOW tới gateway
+
+#ifndef NODE_ROLE
+#define NODE_ROLE NODE_ROLE_STANDALONE
+#endif
+
+// Gateway chỉ nhận frame từ các leaf liệt kê ở đây (MAC leaf in ra lúc khởi động):
+// build_flags = -DGATEWAY_LEAF_MACS=\"24:6f:28:aa:bb:cc,24:6f:28:11:22:33\"
+#ifndef GATEWAY_LEAF_MACS
+#define GATEWAY_LEAF_MACS ""
+#endif
+
+void initNodeLink(); // gọi trong setup()
+void loopNodeLink(); // gọi trong loop()
+
+// Gửi bản ghi lên: leaf → ESP-NOW, vai trò khác → sendSensorData() (AWS)
+void reportSensorData(float temp, float hum, int gas, bool flame, bool danger,
+                      DataPriority priority = PRIORITY_ROUTINE);
+
+#endif
@@ -0,0 +1,29 @@
+#include "EspOTASink.h"
+#include "logging/Logger.h"
+#include <Update.h>
+#include <esp_ota_ops.h>
+
+EspOTASink::EspOTASink() : running(nullptr) {}
+
+bool EspOTASink::begin(size_t imageSize) {
+    running = esp_ota_get_running_partition();
+    return Update.begin(imageSize, U_FLASH);
+}
+
+bool EspOTASink::write(const uint8_t* data, size_t len) {
+    return Update.write(const_cast<uint8_t*>(data), len) == len;
+}
+
+bool EspOTASink::readBase(size_t offset, uint8_t* data, size_t len) {
+    if (!running || offset + len > running->size) return false;
+    return esp_partition_read(running, offset, data, len) == ESP_OK;
+}
+
+// Update.end() kiểm tra đủ kích thước, xác thực image và đặt boot partition mới
+bool EspOTASink::finish() {
+    if (Update.end()) return true;
+    LOG_E("[OTA] Update.end failed: %s", Update.errorString());
+    return false;
+}
+
+void EspOTASink::abort() { Update.abort(); }
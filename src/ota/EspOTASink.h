@@ -0,0 +1,22 @@
+#ifndef ESPOTASINK_H
+#define ESPOTASINK_H
+
+#include "OTASink.h"
+#include <esp_partition.h>
+
+// Ghi vào partition OTA đang không chạy (app0/app1) qua thư viện Update.
+// Update xoá flash từng sector 4 KB khi ghi tới, nên không block lâu như xoá cả partition.
+class EspOTASink : public OTASink {
+  public:
+    EspOTASink();
+    bool begin(size_t imageSize) override;
+    bool write(const uint8_t* data, size_t len) override;
+    bool readBase(size_t offset, uint8_t* data, size_t len) override;
+    bool finish() override;
+    void abort() override;
+
+  private:
+    const esp_partition_t* running;
+};
+
+#endif
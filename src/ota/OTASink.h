@@ -0,0 +1,19 @@
+#ifndef OTASINK_H
+#define OTASINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Nơi ghi firmware mới. Trên ESP32 là partition OTA đang không chạy (EspOTASink),
+// trên host là file (tools/ota_host) để test không cần board.
+class OTASink {
+  public:
+    virtual ~OTASink() {}
+    virtual bool begin(size_t imageSize) = 0;                            // chuẩn bị vùng ghi
+    virtual bool write(const uint8_t* data, size_t len) = 0;             // ghi tuần tự
+    virtual bool readBase(size_t offset, uint8_t* data, size_t len) = 0; // đọc image đang chạy (delta)
+    virtual bool finish() = 0;                                           // chọn image mới cho lần boot sau
+    virtual void abort() = 0;
+};
+
+#endif
@@ -0,0 +1,325 @@
+#include "OTAUpdater.h"
+#include "logging/Logger.h"
+
+// Định dạng bản vá delta: "DLT1" rồi chuỗi lệnh
+//   'C' src:u32le len:u32le  → chép len byte từ image đang chạy tại offset src
+//   'I' len:u32le <len byte> → chèn dữ liệu mới
+static const uint8_t DELTA_MAGIC[4] = {'D', 'L', 'T', '1'};
+
+static uint32_t readU32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+OTAUpdater::OTAUpdater(WiFiClient& n, OTASink& s) : net(n), sink(s), state(IDLE), error(nullptr) {}
+
+bool OTAUpdater::parseUrl(const char* url) {
+    const char* prefix = "http://";
+    if (strncmp(url, prefix, strlen(prefix)) != 0) return false;
+    const char* p = url + strlen(prefix);
+    const char* slash = strchr(p, '/');
+    const char* colon = strchr(p, ':');
+    if (!slash) slash = p + strlen(p);
+    if (colon && colon > slash) colon = nullptr;
+
+    size_t hostLen = (colon ? colon : slash) - p;
+    if (hostLen == 0 || hostLen >= sizeof(host)) return false;
+    memcpy(host, p, hostLen);
+    host[hostLen] = 0;
+    port = colon ? (uint16_t)atoi(colon + 1) : 80;
+
+    if (strlen(slash) >= sizeof(path)) return false;
+    strcpy(path, *slash ? slash : "/");
+    return port != 0;
+}
+
+bool OTAUpdater::start(const char* url, size_t size, const char* sha256Hex, bool useDelta) {
+    if (isActive()) return false;
+    if (!url || !parseUrl(url) || size == 0 || !sha256Hex || strlen(sha256Hex) != 64) {
+        fail("invalid OTA request");
+        return false;
+    }
+    strcpy(expectedSha, sha256Hex);
+    delta = useDelta;
+    imageSize = size;
+    imageWritten = 0;
+    downloaded = 0;
+    rxPos = rxLen = 0;
+    retries = 0;
+    resumes = 0;
+    error = nullptr;
+    deltaHeaderLen = 0;
+    copySrc = copyRemaining = insertRemaining = 0;
+    deltaMagicOk = false;
+    sha.reset();
+
+    if (!sink.begin(imageSize)) {
+        state = FAILED;
+        error = "no OTA partition";
+        LOG_E("[OTA] Cannot begin update: no OTA partition / not enough space");
+        return false;
+    }
+
+    LOG_I("[OTA] Start %s (%u bytes%s)", url, (unsigned)imageSize, delta ? ", delta" : "");
+    state = CONNECTING;
+    return true;
+}
+
+void OTAUpdater::cancel() {
+    if (isActive()) fail("cancelled");
+}
+
+void OTAUpdater::loop() {
+    switch (state) {
+    case CONNECTING:
+        openConnection();
+        break;
+    case READING_HEADERS:
+        readHeaders();
+        break;
+    case DOWNLOADING:
+        pump();
+        break;
+    case WAIT_RETRY:
+        if ((long)(millis() - retryAt) >= 0) state = CONNECTING;
+        break;
+    default:
+        break;
+    }
+}
+
+// ------------------ KẾT NỐI HTTP ------------------
+// Kết nối có timeout ngắn: server chậm/không tới được chỉ làm trễ loop() tối đa
+// OTA_CONNECT_TIMEOUT_MS, phần chờ còn lại nằm ở WAIT_RETRY (không chặn)
+void OTAUpdater::openConnection() {
+    if (!net.connect(host, port, OTA_CONNECT_TIMEOUT_MS)) {
+        connectionLost("connect failed");
+        return;
+    }
+
+    char request[320];
+    int n = snprintf(request, sizeof(request),
+                     "GET %s HTTP/1.1\r\nHost: %s\r\nRange: bytes=%u-\r\n"
+                     "User-Agent: ESP32-OTA\r\nConnection: close\r\n\r\n",
+                     path, host, (unsigned)downloaded);
+    if (n <= 0 || (size_t)n >= sizeof(request) || net.write((const uint8_t*)request, n) != (size_t)n) {
+        connectionLost("request failed");
+        return;
+    }
+
+    if (downloaded > 0) {
+        resumes++;
+        LOG_I("[OTA] Resuming at %u bytes", (unsigned)downloaded);
+    }
+    headerLen = 0;
+    httpStatus = 0;
+    contentRemaining = -1;
+    skip = 0;
+    lastActivity = millis();
+    state = READING_HEADERS;
+}
+
+void OTAUpdater::readHeaders() {
+    while (net.available()) {
+        int c = net.read();
+        if (c < 0) break;
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (headerLen < sizeof(header) - 1) header[headerLen++] = (char)c;
+            continue;
+        }
+
+        header[headerLen] = 0;
+        if (headerLen == 0) { // dòng trống → hết header
+            if (httpStatus == 200 && downloaded > 0) {
+                skip = downloaded; // server không hỗ trợ Range, bỏ qua phần đã có
+            } else if (httpStatus != 200 && httpStatus != 206) {
+                fail(httpStatus == 416 ? "range not satisfiable" : "bad HTTP status");
+                return;
+            }
+            if (contentRemaining == 0) {
+                connectionLost("empty response");
+                return;
+            }
+            state = DOWNLOADING;
+            lastActivity = millis();
+            return;
+        }
+
+        if (httpStatus == 0) {
+            const char* sp = strchr(header, ' ');
+            httpStatus = sp ? atoi(sp + 1) : -1;
+        } else if (strncasecmp(header, "Content-Length:", 15) == 0) {
+            contentRemaining = atol(header + 15);
+        }
+        headerLen = 0;
+    }
+
+    if (!net.connected()) {
+        connectionLost("closed during headers");
+    } else if (millis() - lastActivity > OTA_STALL_TIMEOUT_MS) {
+        connectionLost("header timeout");
+    }
+}
+
+// ------------------ NHẬN DỮ LIỆU ------------------
+// Mỗi lần gọi xử lý tối đa OTA_MAX_BYTES_PER_LOOP byte image, không bao giờ chờ socket
+void OTAUpdater::pump() {
+    size_t budget = OTA_MAX_BYTES_PER_LOOP;
+    uint8_t base[256];
+
+    while (budget > 0 && state == DOWNLOADING) {
+        if (copyRemaining > 0) {
+            size_t n = copyRemaining;
+            if (n > sizeof(base)) n = sizeof(base);
+            if (n > budget) n = budget;
+            if (!sink.readBase(copySrc, base, n)) {
+                fail("read base image failed");
+                return;
+            }
+            if (!emit(base, n)) return;
+            copySrc += n;
+            copyRemaining -= n;
+            budget -= n;
+            continue;
+        }
+
+        if (rxPos < rxLen) {
+            size_t n = rxLen - rxPos;
+            if (n > budget) n = budget;
+            if (delta) {
+                n = consumeDelta(rx + rxPos, n);
+                if (state != DOWNLOADING) return;
+            } else if (!emit(rx + rxPos, n)) {
+                return;
+            }
+            rxPos += n;
+            budget -= n > 0 ? n : 1;
+            continue;
+        }
+
+        if (imageWritten == imageSize) {
+            complete();
+            return;
+        }
+
+        int avail = net.available();
+        if (avail <= 0) break;
+        size_t want = (size_t)avail < sizeof(rx) ? (size_t)avail : sizeof(rx);
+        if (contentRemaining >= 0 && (long)want > contentRemaining) want = (size_t)contentRemaining;
+        int n = want > 0 ? net.read(rx, want) : 0;
+        if (n <= 0) break;
+
+        lastActivity = millis();
+        if (contentRemaining >= 0) contentRemaining -= n;
+
+        size_t start = 0;
+        if (skip > 0) {
+            start = (size_t)n < skip ? (size_t)n : skip;
+            skip -= start;
+        }
+        rxPos = start;
+        rxLen = (size_t)n;
+        downloaded += rxLen - start;
+        if (rxLen > start) retries = 0; // chỉ tính là có tiến triển khi nhận được byte mới
+    }
+
+    if (state != DOWNLOADING || rxPos < rxLen || copyRemaining > 0) return;
+    if (imageWritten == imageSize) {
+        complete();
+    } else if (contentRemaining == 0 || !net.connected()) {
+        connectionLost("connection closed");
+    } else if (millis() - lastActivity > OTA_STALL_TIMEOUT_MS) {
+        connectionLost("stalled");
+    }
+}
+
+size_t OTAUpdater::consumeDelta(const uint8_t* data, size_t len) {
+    size_t used = 0;
+    while (used < len && copyRemaining == 0) {
+        if (insertRemaining > 0) {
+            size_t n = len - used;
+            if (n > insertRemaining) n = insertRemaining;
+            if (!emit(data + used, n)) return used;
+            insertRemaining -= n;
+            used += n;
+            continue;
+        }
+
+        // Gom đủ header (magic hoặc lệnh) rồi mới giải mã
+        size_t need = !deltaMagicOk ? 4 : (deltaHeaderLen > 0 && deltaHeader[0] == 'C') ? 9 : 5;
+        deltaHeader[deltaHeaderLen++] = data[used++];
+        if (deltaHeaderLen < need) continue;
+        deltaHeaderLen = 0;
+
+        if (!deltaMagicOk) {
+            if (memcmp(deltaHeader, DELTA_MAGIC, 4) != 0) {
+                fail("bad delta header");
+                return used;
+            }
+            deltaMagicOk = true;
+        } else if (deltaHeader[0] == 'C') {
+            copySrc = readU32(deltaHeader + 1);
+            copyRemaining = readU32(deltaHeader + 5);
+        } else if (deltaHeader[0] == 'I') {
+            insertRemaining = readU32(deltaHeader + 1);
+        } else {
+            fail("bad delta op");
+            return used;
+        }
+    }
+    return used;
+}
+
+bool OTAUpdater::emit(const uint8_t* data, size_t len) {
+    if (imageWritten + len > imageSize) {
+        fail("image larger than expected");
+        return false;
+    }
+    sha.update(data, len);
+    if (!sink.write(data, len)) {
+        fail("flash write failed");
+        return false;
+    }
+    imageWritten += len;
+    return true;
+}
+
+// ------------------ KẾT THÚC ------------------
+void OTAUpdater::complete() {
+    net.stop();
+
+    uint8_t digest[32];
+    sha.finish(digest);
+    if (!Sha256::matchesHex(digest, expectedSha)) {
+        fail("SHA-256 mismatch");
+        return;
+    }
+    if (!sink.finish()) {
+        fail("cannot activate new image");
+        return;
+    }
+
+    state = DONE;
+    LOG_I("[OTA] Done: %u bytes image, %u bytes downloaded, %u resumes",
+          (unsigned)imageWritten, (unsigned)downloaded, resumes);
+}
+
+void OTAUpdater::connectionLost(const char* reason) {
+    net.stop();
+    if (++retries > OTA_MAX_RETRIES) {
+        fail(reason);
+        return;
+    }
+    LOG_W("[OTA] %s at %u bytes, retry %u/%u", reason, (unsigned)downloaded,
+          retries, (unsigned)OTA_MAX_RETRIES);
+    retryAt = millis() + OTA_RETRY_MS;
+    state = WAIT_RETRY;
+}
+
+void OTAUpdater::fail(const char* reason) {
+    net.stop();
+    if (state != IDLE && state != DONE && state != FAILED) sink.abort();
+    state = FAILED;
+    error = reason;
+    LOG_E("[OTA] Failed: %s", reason);
+}
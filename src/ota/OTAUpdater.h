@@ -0,0 +1,90 @@
+#ifndef OTAUPDATER_H
+#define OTAUPDATER_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "OTASink.h"
+#include "Sha256.h"
+
+#define OTA_CHUNK_SIZE 1024            // byte đọc từ socket mỗi lần
+#define OTA_MAX_BYTES_PER_LOOP 4096    // giới hạn mỗi lần loop() để vòng cảm biến không bị trễ
+#define OTA_RETRY_MS 2000              // chờ trước khi nối lại sau khi rớt kết nối
+#define OTA_MAX_RETRIES 20
+#define OTA_STALL_TIMEOUT_MS 15000     // không nhận được byte nào trong khoảng này → nối lại
+#define OTA_CONNECT_TIMEOUT_MS 500     // chờ bắt tay TCP tối đa, quá hạn → thử lại sau OTA_RETRY_MS
+
+// Tải firmware qua HTTP theo kiểu streaming, ghi dần vào sink và băm SHA-256 song song.
+// Rớt kết nối → nối lại với header Range từ offset đã nhận (resume).
+// Nếu bật delta, dữ liệu tải về là bản vá (xem tools/ota_host/make_delta.py),
+// được giải mã dần dựa trên image đang chạy; SHA-256 luôn tính trên image đích.
+class OTAUpdater {
+  public:
+    enum State { IDLE, CONNECTING, READING_HEADERS, DOWNLOADING, WAIT_RETRY, DONE, FAILED };
+
+    OTAUpdater(WiFiClient& net, OTASink& sink);
+
+    // url dạng http://host[:port]/path; imageSize và sha256 là của image đích
+    bool start(const char* url, size_t imageSize, const char* sha256Hex, bool delta = false);
+    void loop();   // non-blocking, gọi thường xuyên từ loop()
+    void cancel();
+
+    State getState() const { return state; }
+    bool isActive() const { return state != IDLE && state != DONE && state != FAILED; }
+    size_t getImageWritten() const { return imageWritten; }
+    size_t getImageSize() const { return imageSize; }
+    size_t getDownloaded() const { return downloaded; }
+    unsigned getResumes() const { return resumes; }
+    const char* getError() const { return error; }
+
+  private:
+    bool parseUrl(const char* url);
+    void openConnection();
+    void readHeaders();
+    void pump();
+    size_t consumeDelta(const uint8_t* data, size_t len); // trả về số byte đã dùng
+    bool emit(const uint8_t* data, size_t len);           // byte của image đích
+    void connectionLost(const char* reason);
+    void fail(const char* reason);
+    void complete();
+
+    WiFiClient& net; // cần connect() có timeout, Client chung chỉ có bản chặn
+    OTASink& sink;
+    Sha256 sha;
+
+    State state;
+    char host[64];
+    char path[128];
+    uint16_t port;
+    char expectedSha[65];
+    bool delta;
+
+    size_t imageSize;      // kích thước image đích
+    size_t imageWritten;   // số byte image đã ghi vào sink
+    size_t downloaded;     // số byte tải về (offset cho Range)
+    long contentRemaining; // byte còn lại của response hiện tại, -1 nếu không rõ
+    size_t skip;           // server bỏ qua Range (trả 200) → bỏ qua phần đã nhận
+
+    uint8_t rx[OTA_CHUNK_SIZE]; // dữ liệu đã nhận nhưng chưa xử lý (giữ nguyên khi resume)
+    size_t rxPos;
+    size_t rxLen;
+
+    char header[256];      // dòng header HTTP đang đọc
+    size_t headerLen;
+    int httpStatus;
+
+    unsigned long lastActivity;
+    unsigned long retryAt;
+    unsigned retries;
+    unsigned resumes;
+    const char* error;
+
+    // Trạng thái bộ giải mã delta (giữ qua các lần resume)
+    uint8_t deltaHeader[9];
+    size_t deltaHeaderLen;
+    uint32_t copySrc;      // lệnh COPY đang chạy: offset trong image cũ
+    uint32_t copyRemaining;
+    uint32_t insertRemaining;
+    bool deltaMagicOk;
+};
+
+#endif
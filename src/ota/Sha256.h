@@ -0,0 +1,27 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SHA-256 tính dần theo từng chunk (không cần giữ cả image trong RAM)
+class Sha256 {
+  public:
+    Sha256();
+    void reset();
+    void update(const uint8_t* data, size_t len);
+    void finish(uint8_t digest[32]);
+
+    // So sánh digest với chuỗi hex 64 ký tự (không phân biệt hoa thường)
+    static bool matchesHex(const uint8_t digest[32], const char* hex);
+
+  private:
+    void transform(const uint8_t block[64]);
+
+    uint32_t state[8];
+    uint64_t bitLength;
+    uint8_t buffer[64];
+    size_t bufferLen;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "ota_update.h"
+#include "ota/OTAUpdater.h"
+#include "ota/EspOTASink.h"
+#include "logging/Logger.h"
+#include <WiFi.h>
+#include <Preferences.h>
+#include <ArduinoJson.h>
+#include <esp_ota_ops.h>
+#include <esp_system.h>
+
+// ------------------ KHAI BÁO TOÀN CỤC ------------------
+static WiFiClient otaNet; // image tải qua HTTP thường; tính toàn vẹn dựa vào SHA-256 nhận qua MQTT/TLS
+static EspOTASink otaSink;
+static OTAUpdater updater(otaNet, otaSink);
+static Preferences otaPrefs;
+
+static bool pendingVerify = false;     // đang chạy image mới chưa được xác nhận
+static bool imageCommitted = false;    // đã ghi cờ "pending" cho image vừa tải xong
+
+// Bỏ qua bước xác nhận tự động của Arduino core, tự xác nhận trong loopOTA()
+extern "C" bool verifyRollbackLater() { return true; }
+
+// ------------------ ROLLBACK ------------------
+// Đánh dấu image đang chạy là hỏng và khởi động lại: bootloader tự chọn image trước đó
+static void rollback(const char* reason) {
+    LOG_W("[OTA] Rollback: %s", reason);
+    otaPrefs.putBool("pending", false);
+    logFlush();
+    delay(100);
+
+    esp_ota_mark_app_invalid_rollback_and_reboot(); // chỉ trả về khi không có image cũ hợp lệ
+    LOG_E("[OTA] No valid previous image, keep running current one");
+    esp_ota_mark_app_valid_cancel_rollback();
+    pendingVerify = false;
+}
+
+static void confirmImage() {
+    pendingVerify = false;
+    if (!imageCommitted) otaPrefs.putBool("pending", false); // cờ lúc này thuộc image kế tiếp
+    esp_ota_mark_app_valid_cancel_rollback();
+    LOG_I("[OTA] New image confirmed ✅");
+}
+
+void initOTA() {
+    otaPrefs.begin("ota", false);
+    if (!otaPrefs.getBool("pending", false)) return;
+
+    // Thức dậy từ deep sleep (chế độ pin) không phải một lần khởi động lại do lỗi: không tính
+    uint8_t tries = otaPrefs.getUChar("tries", 0);
+    if (esp_reset_reason() != ESP_RST_DEEPSLEEP) otaPrefs.putUChar("tries", ++tries);
+    LOG_I("[OTA] New image booted (try %u/%u), waiting for self-test",
+          tries, OTA_MAX_BOOT_TRIES);
+    if (tries > OTA_MAX_BOOT_TRIES) {
+        rollback("too many boot attempts");
+        return;
+    }
+    pendingVerify = true;
+}
+
+void loopOTA(bool danger) {
+    updater.loop();
+
+    // Tự kiểm tra: vòng cảm biến đã chạy đủ OTA_SELFTEST_MS mà không crash-reboot (reset giữa chừng
+    // được initOTA() đếm). Mạng không tính: mất WiFi/internet sau khi cập nhật không phải lỗi image
+    if (pendingVerify && millis() >= OTA_SELFTEST_MS) confirmImage();
+
+    if (updater.getState() != OTAUpdater::DONE) return;
+
+    // Boot partition đã trỏ sang image mới ngay khi updater DONE: ghi cờ luôn, để mất điện
+    // trước khi kịp restart thì lần boot sau vẫn chạy bước xác nhận/rollback
+    if (!imageCommitted) {
+        otaPrefs.putBool("pending", true);
+        otaPrefs.putUChar("tries", 0);
+        imageCommitted = true;
+    }
+
+    // Khởi động lại vào image mới, nhưng không cắt ngang lúc đang báo động
+    if (!danger) {
+        LOG_I("[OTA] Rebooting into new image...");
+        logFlush();
+        delay(100);
+        ESP.restart();
+    }
+}
+
+bool handleOTACommand(const byte* payload, unsigned int length) {
+    StaticJsonDocument<384> doc;
+    if (deserializeJson(doc, payload, length)) return false;
+
+    const char* cmd = doc["cmd"];
+    if (!cmd || strcmp(cmd, "ota") != 0) return false;
+
+    if (updater.isActive()) {
+        LOG_W("[OTA] Update already in progress, ignoring command");
+        return true;
+    }
+    updater.start(doc["url"], doc["size"] | 0, doc["sha256"], doc["delta"] | false);
+    return true;
+}
+
+void confirmOTA() {
+    if (pendingVerify) confirmImage();
+}
+
+bool isOTAActive() { return updater.isActive(); }
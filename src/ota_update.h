@@ -0,0 +1,21 @@
+#ifndef OTA_UPDATE_H
+#define OTA_UPDATE_H
+
+#include <Arduino.h>
+
+// Firmware mới được xác nhận khi vòng cảm biến chạy đủ thời gian này mà không reset (không cần mạng)
+#define OTA_SELFTEST_MS 30000
+#define OTA_MAX_BOOT_TRIES 3 // reset liên tục quá số lần này → quay về image cũ
+
+void initOTA();             // gọi trong setup(), kiểm tra image mới chờ xác nhận
+void loopOTA(bool danger);  // gọi trong loop(); không khởi động lại khi đang nguy hiểm
+void confirmOTA();          // chế độ pin: một chu kỳ đo trọn vẹn là đủ tự kiểm tra, xác nhận ngay
+
+// Lệnh OTA nhận qua MQTT:
+// {"cmd":"ota","url":"http://host:port/fw.bin","size":123456,"sha256":"<hex>","delta":false}
+// Trả về true nếu payload là lệnh OTA (dù hợp lệ hay không)
+bool handleOTACommand(const byte* payload, unsigned int length);
+
+bool isOTAActive();
+
+#endif
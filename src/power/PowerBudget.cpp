@@ -0,0 +1,39 @@
+#include "PowerBudget.h"
+#include <string.h>
+
+void PowerBudget::clear() { memset(this, 0, sizeof(*this)); }
+
+void PowerBudget::addAwake(const CycleTiming& t, bool booted) {
+    activeMs += t.activeMs + (booted ? POWER_BOOT_MS : 0);
+    radioMs += t.radioMs;
+    lightSleepMs += t.lightSleepMs;
+    heaterMs += t.heaterMs;
+    if (booted) cycles++;
+}
+
+void PowerBudget::addSleep(uint32_t ms, bool heaterOn) {
+    sleepMs += ms;
+    if (heaterOn) heaterMs += ms;
+}
+
+// Điện tích (mA·ms) chia tổng thời gian
+static float averageOf(double active, double radio, double light, double heater, double sleep) {
+    double total = active + radio + light + sleep;
+    if (total <= 0) return 0;
+    double charge = active * POWER_ACTIVE_MA + radio * POWER_RADIO_MA + light * POWER_LIGHT_SLEEP_MA +
+                    sleep * POWER_SLEEP_MA + heater * POWER_HEATER_MA;
+    return (float)(charge / total);
+}
+
+float PowerBudget::averageMa() const {
+    return averageOf(activeMs, radioMs, lightSleepMs, heaterMs, sleepMs);
+}
+
+float PowerBudget::batteryDays(float capacityMah) const {
+    float ma = averageMa();
+    return ma > 0 ? capacityMah / ma / 24.0f : 0;
+}
+
+float PowerBudget::cycleMa(const CycleTiming& t) {
+    return averageOf(t.activeMs + POWER_BOOT_MS, t.radioMs, t.lightSleepMs, t.heaterMs, t.sleepMs);
+}
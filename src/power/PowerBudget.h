@@ -0,0 +1,55 @@
+#ifndef POWERBUDGET_H
+#define POWERBUDGET_H
+
+#include <stdint.h>
+
+// Dòng tiêu thụ từng pha (mA), board ESP32 trần (không LED nguồn, không chip USB-UART).
+// Chỉnh theo phép đo thực tế bằng build_flags, ví dụ -DPOWER_RADIO_MA=140
+#ifndef POWER_SLEEP_MA
+#define POWER_SLEEP_MA 0.15f      // ESP32 deep sleep ~10 uA + DHT11 chờ + LM393 module lửa
+#endif
+#ifndef POWER_ACTIVE_MA
+#define POWER_ACTIVE_MA 40.0f     // CPU chạy, radio tắt
+#endif
+#ifndef POWER_LIGHT_SLEEP_MA
+#define POWER_LIGHT_SLEEP_MA 1.0f // chờ heater MQ2
+#endif
+#ifndef POWER_RADIO_MA
+#define POWER_RADIO_MA 120.0f     // WiFi kết nối + TLS + publish, trung bình
+#endif
+#ifndef POWER_HEATER_MA
+#define POWER_HEATER_MA 150.0f    // heater MQ2 (~750 mW ở 5 V)
+#endif
+#ifndef POWER_BOOT_MS
+#define POWER_BOOT_MS 250         // ROM + bootloader trước khi app chạy, esp_timer không đo được
+#endif
+
+// Thời gian từng pha trong một chu kỳ thức (ms). heaterMs chồng lên các pha khác.
+struct CycleTiming {
+    uint32_t activeMs;
+    uint32_t radioMs;
+    uint32_t lightSleepMs;
+    uint32_t heaterMs;
+    uint32_t sleepMs; // dự kiến, chỉ dùng cho cycleMa()
+};
+
+// Ước lượng dòng trung bình từ thời gian đo được của từng pha, cộng dồn từ lúc cấp nguồn.
+// POD để đặt trong RTC memory như SampleRing.
+struct PowerBudget {
+    uint64_t activeMs;
+    uint64_t radioMs;
+    uint64_t lightSleepMs;
+    uint64_t heaterMs;
+    uint64_t sleepMs;
+    uint32_t cycles;
+
+    void clear();
+    void addAwake(const CycleTiming& t, bool booted); // lúc đi ngủ (không tính sleepMs); booted: cộng POWER_BOOT_MS
+    void addSleep(uint32_t ms, bool heaterOn); // lúc thức dậy, thời gian ngủ thật
+
+    float averageMa() const;
+    float batteryDays(float capacityMah) const;
+    static float cycleMa(const CycleTiming& t); // chu kỳ đơn lẻ với thời gian ngủ dự kiến
+};
+
+#endif
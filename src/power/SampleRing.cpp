@@ -0,0 +1,56 @@
+#include "SampleRing.h"
+#include <math.h>
+#include <string.h>
+
+void SampleRing::clear() {
+    memset(this, 0, sizeof(*this));
+    magic = SAMPLE_RING_MAGIC;
+}
+
+void SampleRing::push(const SensorData& data, uint32_t clockMs) {
+    if (count == SAMPLE_RING_CAPACITY) {
+        uint16_t victim = 0;
+        while (victim < count && (items[(head + victim) % SAMPLE_RING_CAPACITY].flags & SAMPLE_FLAG_ALARM)) victim++;
+        if (victim == count) {
+            victim = 0;
+            alarmOverwrites++;
+        }
+        // Dồn các bản mới hơn victim lùi một ô, giữ thứ tự cũ → mới
+        for (uint16_t i = victim; i + 1 < count; i++) {
+            items[(head + i) % SAMPLE_RING_CAPACITY] = items[(head + i + 1) % SAMPLE_RING_CAPACITY];
+        }
+        count--;
+        overwrites++;
+    }
+
+    RtcSample& s = items[(head + count) % SAMPLE_RING_CAPACITY];
+    s.clockMs = clockMs;
+    s.temp10 = (int16_t)lroundf(data.temp * 10);
+    s.hum10 = (uint16_t)lroundf(data.hum * 10);
+    s.gas = (uint16_t)(data.gas < 0 ? 0 : data.gas > 65535 ? 65535 : data.gas);
+    s.flags = (data.flame ? SAMPLE_FLAG_FLAME : 0) | (data.danger ? SAMPLE_FLAG_DANGER : 0) |
+              (data.priority == PRIORITY_ALARM ? SAMPLE_FLAG_ALARM : 0);
+    s.reserved = 0;
+    count++;
+}
+
+bool SampleRing::peek(SensorData& data, uint32_t nowClockMs, uint64_t nowMonoUs) const {
+    if (count == 0) return false;
+
+    const RtcSample& s = items[head];
+    uint32_t ageMs = nowClockMs - s.clockMs;
+    data.temp = s.temp10 / 10.0f;
+    data.hum = s.hum10 / 10.0f;
+    data.gas = s.gas;
+    data.flame = s.flags & SAMPLE_FLAG_FLAME;
+    data.danger = s.flags & SAMPLE_FLAG_DANGER;
+    data.priority = (s.flags & SAMPLE_FLAG_ALARM) ? PRIORITY_ALARM : PRIORITY_ROUTINE;
+    data.capturedUs = nowMonoUs - (uint64_t)ageMs * 1000;
+    return true;
+}
+
+void SampleRing::drop() {
+    if (count == 0) return;
+    head = (head + 1) % SAMPLE_RING_CAPACITY;
+    count--;
+}
@@ -0,0 +1,48 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include "telemetry/SensorData.h"
+
+// Buffer bản ghi qua các chu kỳ deep sleep (RTC slow memory, 8 KB trên ESP32)
+#define SAMPLE_RING_CAPACITY 96 // 96 x 12 byte; 48 phút ở chu kỳ 30 s
+#define SAMPLE_RING_MAGIC 0x53524E47
+
+#define SAMPLE_FLAG_FLAME 0x01
+#define SAMPLE_FLAG_DANGER 0x02
+#define SAMPLE_FLAG_ALARM 0x04
+
+// Bản ghi gọn 12 byte; thời điểm đo theo đồng hồ bền qua deep sleep (low_power.cpp),
+// đơn vị ms, quấn sau 49 ngày (chỉ dùng hiệu hai mốc nên không ảnh hưởng)
+struct RtcSample {
+    uint32_t clockMs;
+    int16_t temp10;
+    uint16_t hum10;
+    uint16_t gas;
+    uint8_t flags;
+    uint8_t reserved;
+};
+
+// Không có constructor: biến RTC_DATA_ATTR không được khởi tạo lại khi thức dậy từ deep sleep.
+// Nội dung kiểm tra bằng valid(), gọi clear() sau khi mất nguồn.
+struct SampleRing {
+    uint32_t magic;
+    uint16_t head;
+    uint16_t count;
+    uint32_t overwrites; // bản cũ bị bỏ khi đầy (gửi lỗi quá lâu)
+    uint32_t alarmOverwrites; // trong đó là alarm: chỉ xảy ra khi cả buffer toàn alarm
+    RtcSample items[SAMPLE_RING_CAPACITY];
+
+    void clear();
+    bool valid() const { return magic == SAMPLE_RING_MAGIC && head < SAMPLE_RING_CAPACITY && count <= SAMPLE_RING_CAPACITY; }
+
+    // Đầy → bỏ bản routine cũ nhất; alarm chỉ bị bỏ khi cả buffer toàn alarm (như làn alarm của TelemetryQueue)
+    void push(const SensorData& data, uint32_t clockMs);
+
+    // Bản cũ nhất, capturedUs quy về monotonicUs() của lần thức hiện tại
+    // (có thể "âm" theo kiểu quấn uint64, TimeBase/serialize vẫn tính đúng tuổi)
+    bool peek(SensorData& data, uint32_t nowClockMs, uint64_t nowMonoUs) const;
+    void drop();
+    uint16_t size() const { return count; }
+};
+
+#endif
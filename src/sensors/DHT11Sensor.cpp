@@ -17,5 +17,15 @@ void DHT11Sensor::update() {
   }
 }
 
+bool DHT11Sensor::readNow() {
+  float t = dht.readTemperature(false, true);
+  float h = dht.readHumidity();
+  lastReadTime = millis();
+  if (isnan(t) || isnan(h)) return false;
+  cachedTemp = t;
+  cachedHum = h;
+  return true;
+}
+
 float DHT11Sensor::readTemperature() { return cachedTemp; }
 float DHT11Sensor::readHumidity() { return cachedHum; }
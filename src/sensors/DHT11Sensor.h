@@ -8,6 +8,7 @@ class DHT11Sensor {
     DHT11Sensor(uint8_t pin);
     void begin();
     void update();
+    bool readNow(); // đọc ngay, bỏ qua giới hạn 2s (vừa thức dậy từ deep sleep)
     float readTemperature();
     float readHumidity();
   private:
@@ -8,6 +8,7 @@ class FlameSensor {
     FlameSensor(uint8_t pin);
     void begin();
     bool isStableFlame(unsigned long debounceDelay = 100); // chống nhiễu 100ms mặc định
+    uint8_t getPin() const { return pin; }
 
   private:
     uint8_t pin;
@@ -1,4 +1,7 @@
 #include "MQ2Sensor.h"
+#include "../logging/Logger.h"
+
+static const uint8_t DANGER_CONFIRM_READS = 3; // số lần vượt ngưỡng liên tiếp để báo nguy hiểm
 
 MQ2Sensor::MQ2Sensor(uint8_t analogPin, uint16_t th) {
   pin = analogPin;
@@ -10,17 +13,27 @@ void MQ2Sensor::begin() {
   stableStart = millis();
   calibrated = false;
   ready = false;
-  Serial.println(F("MQ2 Sensor initialized, warming up..."));
+  LOG_I("MQ2 Sensor initialized, warming up...");
 }
 
 void MQ2Sensor::update() {
   // Chờ cảm biến làm nóng
   if (!ready && millis() - stableStart >= warmupTime) {
     ready = true;
-    calibrate(); // hiệu chỉnh sau khi warm-up
+    if (!calibrated) calibrate(); // hiệu chỉnh sau khi warm-up, trừ khi đã có mức nền lưu sẵn
   }
 }
 
+void MQ2Sensor::setWarmup(unsigned long ms) {
+  warmupTime = ms;
+}
+
+// Gọi sau begin(): mức nền hiệu chỉnh lúc không khí sạch, không đo lại khi có thể đang có gas
+void MQ2Sensor::setBaseLevel(int base) {
+  baseLevel = base;
+  calibrated = true;
+}
+
 bool MQ2Sensor::isReady() {
   return ready && calibrated;
 }
@@ -33,7 +46,7 @@ void MQ2Sensor::calibrate(uint16_t samples) {
   }
   baseLevel = sum / samples;
   calibrated = true;
-  Serial.printf("MQ2 Calibrated: base=%d | threshold=%d\n", baseLevel, baseLevel + threshold);
+  LOG_I("MQ2 Calibrated: base=%d | threshold=%d", baseLevel, baseLevel + threshold);
 }
 
 int MQ2Sensor::readAnalog() {
@@ -55,19 +68,21 @@ float MQ2Sensor::readSmooth(float alpha) {
 }
 
 bool MQ2Sensor::isDanger() {
-  if (!calibrated) return false;
+  if (!isReady()) return false; // heater chưa nóng → giá trị đọc chưa tin được
 
   int value = readAnalog();
   int dangerLevel = baseLevel + threshold;
 
   if (value >= dangerLevel) {
-    dangerCount++;
+    // Kẹp ở ngưỡng: không tràn khi gas cao kéo dài, và hết gas thì tắt cảnh báo ngay lần đọc thấp
+    // đầu tiên thay vì phải đếm ngược hàng trăm lần
+    if (dangerCount < DANGER_CONFIRM_READS) dangerCount++;
   } else if (dangerCount > 0) {
     dangerCount--;
   }
 
   // Nếu vượt ngưỡng 3 lần liên tiếp → báo nguy hiểm
-  return dangerCount >= 3;
+  return dangerCount >= DANGER_CONFIRM_READS;
 }
 
 int MQ2Sensor::getBaseLevel() {
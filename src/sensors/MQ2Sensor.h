@@ -10,6 +10,8 @@ class MQ2Sensor {
     void begin();                               // Gọi trong setup()
     void update();                              // Gọi trong loop() (non-blocking)
     bool isReady();                             // Đã warm-up và hiệu chỉnh xong chưa
+    void setWarmup(unsigned long ms);           // Thời gian làm nóng heater tính từ begin()
+    void setBaseLevel(int base);                // Dùng mức nền đã lưu, bỏ qua hiệu chỉnh sau warm-up
 
     int readAnalog();                           // Đọc giá trị trung bình ADC
     float readSmooth(float alpha = 0.2);        // Đọc có trơn hóa tín hiệu
@@ -28,7 +30,7 @@ class MQ2Sensor {
     bool ready = false;
 
     unsigned long stableStart = 0;
-    const unsigned long warmupTime = 5000;      // 5 giây làm nóng
+    unsigned long warmupTime = 5000;            // 5 giây làm nóng (heater luôn bật)
 
     int lastValue = 0;                          // Lưu giá trị đọc cuối
     uint8_t dangerCount = 0;                    // Đếm số lần vượt ngưỡng liên tiếp
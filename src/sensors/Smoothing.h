@@ -0,0 +1,9 @@
+#ifndef SMOOTHING_H
+#define SMOOTHING_H
+
+// Lọc trung bình động hàm mũ (EMA): alpha lớn → bám nhanh, alpha nhỏ → mượt hơn
+inline float emaUpdate(float prev, float sample, float alpha) {
+  return alpha * sample + (1 - alpha) * prev;
+}
+
+#endif
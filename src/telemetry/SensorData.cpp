@@ -0,0 +1,29 @@
+#include "SensorData.h"
+#include "TimeBase.h"
+#include <ArduinoJson.h>
+
+size_t serializeSensorData(const SensorData& data, const char* deviceId, char* payload, size_t size) {
+    StaticJsonDocument<300> doc;
+
+    // Thời điểm đo (không phải lúc gửi), tính từ bộ đếm đơn điệu + offset SNTP hiện tại
+    int64_t epochMs = toEpochMs(data.capturedUs);
+
+    doc["deviceId"] = deviceId;
+    doc["timestamp"] = epochMs / 1000; // giữ trường giây cho backend hiện tại
+    doc["timestampMs"] = epochMs;
+    if (!timeBaseValid()) doc["synced"] = false; // giờ ~1970 trước SNTP: backend bỏ hoặc tự gắn lại mốc
+
+    //  Dùng số thật, không dùng String()
+    doc["temperature"] = data.temp;
+    doc["humidity"]    = data.hum;
+    doc["gas"]         = data.gas;
+
+    JsonObject alert = doc.createNestedObject("alert");
+    alert["flame"]  = data.flame ? 1 : 0;
+    alert["danger"] = data.danger ? 1 : 0;
+
+    doc["priority"] = data.priority == PRIORITY_ALARM ? "alarm" : "routine";
+    doc["queueMs"]  = (monotonicUs() - data.capturedUs) / 1000; // thời gian nằm trong buffer
+
+    return serializeJson(doc, payload, size);
+}
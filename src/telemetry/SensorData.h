@@ -0,0 +1,26 @@
+#ifndef SENSORDATA_H
+#define SENSORDATA_H
+
+#include <Arduino.h>
+
+// Mức ưu tiên của bản ghi gửi lên AWS
+enum DataPriority : uint8_t {
+    PRIORITY_ROUTINE = 0, // dữ liệu định kỳ, giới hạn bởi PUBLISH_INTERVAL
+    PRIORITY_ALARM   = 1  // chuyển trạng thái nguy hiểm, gửi ngay qua buffer riêng
+};
+
+// Một bản ghi cảm biến chờ gửi lên cloud
+struct SensorData {
+    float temp;
+    float hum;
+    int gas;
+    bool flame;
+    bool danger;
+    DataPriority priority;
+    uint64_t capturedUs;      // monotonicUs() lúc đo, đổi sang epoch ms khi đóng gói (TimeBase.h)
+};
+
+// Đóng gói JSON (cùng định dạng backend đang đọc), trả về số byte đã ghi
+size_t serializeSensorData(const SensorData& data, const char* deviceId, char* payload, size_t size);
+
+#endif
@@ -0,0 +1,22 @@
+#include "TelemetryPublisher.h"
+
+bool publishAlarmLane(TelemetryQueue& queue, TelemetrySendFn send, void* ctx) {
+    const SensorData* data;
+    while ((data = queue.peekAlarm()) != nullptr) {
+        if (!send(*data, ctx)) return false;
+        queue.dropAlarm();
+    }
+    return true;
+}
+
+void publishTelemetry(TelemetryQueue& queue, unsigned long now, unsigned long& lastPublishMs,
+                      unsigned long intervalMs, TelemetrySendFn send, void* ctx) {
+    if (!publishAlarmLane(queue, send, ctx)) return;
+
+    if (now - lastPublishMs < intervalMs) return;
+
+    SensorData data;
+    if (!queue.pop(data)) return;
+    if (!send(data, ctx)) queue.push(data);
+    lastPublishMs = now;
+}
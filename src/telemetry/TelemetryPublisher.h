@@ -0,0 +1,20 @@
+#ifndef TELEMETRYPUBLISHER_H
+#define TELEMETRYPUBLISHER_H
+
+#include "TelemetryQueue.h"
+
+// Gửi một bản ghi; false = chưa gửi được (mất kết nối, lỗi publish), bản ghi được giữ lại
+typedef bool (*TelemetrySendFn)(const SensorData& data, void* ctx);
+
+// Đường xả queue dùng chung cho firmware (aws_mqtt.cpp) và tools/fleet_sim.
+
+// Làn alarm: xả hết ngay, không throttle. Bản ghi chỉ bị lấy ra sau khi gửi thành công,
+// lỗi thì dừng để giữ thứ tự. Trả về true nếu làn alarm đã rỗng.
+bool publishAlarmLane(TelemetryQueue& queue, TelemetrySendFn send, void* ctx);
+
+// Alarm trước; alarm chưa gửi hết thì chưa gửi dữ liệu thường.
+// Dữ liệu thường: tối đa một bản ghi mỗi intervalMs, gửi lỗi thì đưa lại vào queue.
+void publishTelemetry(TelemetryQueue& queue, unsigned long now, unsigned long& lastPublishMs,
+                      unsigned long intervalMs, TelemetrySendFn send, void* ctx);
+
+#endif
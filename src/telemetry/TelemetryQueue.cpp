@@ -0,0 +1,43 @@
+#include "TelemetryQueue.h"
+
+TelemetryQueue::TelemetryQueue()
+    : queueStart(0), queueEnd(0), alarmStart(0), alarmCount(0), alarmOverwrites(0) {}
+
+bool TelemetryQueue::push(const SensorData& data) {
+    int next = (queueEnd + 1) % DATA_QUEUE_SIZE;
+    if (next == queueStart) return false; // full
+    dataQueue[queueEnd] = data;
+    queueEnd = next;
+    return true;
+}
+
+bool TelemetryQueue::pop(SensorData& data) {
+    if (queueStart == queueEnd) return false; // empty
+    data = dataQueue[queueStart];
+    queueStart = (queueStart + 1) % DATA_QUEUE_SIZE;
+    return true;
+}
+
+int TelemetryQueue::size() const {
+    return (queueEnd - queueStart + DATA_QUEUE_SIZE) % DATA_QUEUE_SIZE;
+}
+
+// Alarm queue đầy → ghi đè bản cũ nhất, vì trạng thái mới nhất quan trọng hơn
+void TelemetryQueue::pushAlarm(const SensorData& data) {
+    if (alarmCount == ALARM_QUEUE_SIZE) {
+        dropAlarm();
+        alarmOverwrites++;
+    }
+    alarmQueue[(alarmStart + alarmCount) % ALARM_QUEUE_SIZE] = data;
+    alarmCount++;
+}
+
+const SensorData* TelemetryQueue::peekAlarm() const {
+    return alarmCount > 0 ? &alarmQueue[alarmStart] : nullptr;
+}
+
+void TelemetryQueue::dropAlarm() {
+    if (alarmCount == 0) return;
+    alarmStart = (alarmStart + 1) % ALARM_QUEUE_SIZE;
+    alarmCount--;
+}
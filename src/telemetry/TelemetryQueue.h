@@ -0,0 +1,38 @@
+#ifndef TELEMETRYQUEUE_H
+#define TELEMETRYQUEUE_H
+
+#include "SensorData.h"
+
+#define DATA_QUEUE_SIZE 10
+#define ALARM_QUEUE_SIZE 4
+
+// Buffer gửi dữ liệu: queue thường (FIFO, drop khi đầy) + làn ưu tiên cho alarm.
+// Làn alarm có buffer riêng, không bị throttle và không bao giờ bị drop khi queue thường đầy.
+class TelemetryQueue {
+  public:
+    TelemetryQueue();
+
+    // Queue thường
+    bool push(const SensorData& data);          // false nếu đầy
+    bool pop(SensorData& data);                 // false nếu rỗng
+    int size() const;
+
+    // Làn alarm
+    void pushAlarm(const SensorData& data);     // đầy → ghi đè bản cũ nhất
+    const SensorData* peekAlarm() const;        // nullptr nếu rỗng
+    void dropAlarm();                           // gọi sau khi publish thành công
+    int alarmSize() const { return alarmCount; }
+    unsigned long getAlarmOverwrites() const { return alarmOverwrites; }
+
+  private:
+    SensorData dataQueue[DATA_QUEUE_SIZE];
+    int queueStart;
+    int queueEnd;
+
+    SensorData alarmQueue[ALARM_QUEUE_SIZE];
+    int alarmStart;
+    int alarmCount;
+    unsigned long alarmOverwrites;
+};
+
+#endif
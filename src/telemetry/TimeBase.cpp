@@ -0,0 +1,85 @@
+#include "TimeBase.h"
+#include <Arduino.h>
+#include "logging/Logger.h"
+#include "time.h"
+#include <atomic>
+#if defined(ESP32)
+#include <esp_timer.h>
+#endif
+
+// Khoảng cách tối thiểu giữa hai lần sync để ước lượng drift (ngắn quá thì nhiễu mạng lấn át)
+static const uint64_t DRIFT_MIN_INTERVAL_US = 60ULL * 1000000ULL;
+static const float DRIFT_ALPHA = 0.3f;        // lọc trung bình động cho drift
+static const float DRIFT_MAX_PPM = 500.0f;    // thạch anh ESP32 thường < 50 ppm
+static const time_t MIN_VALID_EPOCH_S = 1704067200; // 2024-01-01: đồng hồ hệ thống nhỏ hơn là chưa được đặt
+
+// Mẫu sync chờ xử lý (ghi từ task SNTP, đọc trong loop). Cờ là chủ của slot: task SNTP chỉ ghi khi
+// cờ false và bật cờ (release) sau khi ghi xong; loop chỉ đọc khi thấy cờ true (acquire) và trả slot
+// (release) sau khi đọc xong → hai core không bao giờ thấy cặp giá trị 64-bit ghi dở
+static std::atomic<bool> syncPending(false);
+static int64_t pendingEpochUs = 0;
+static uint64_t pendingMonoUs = 0;
+
+// Mô hình hiện tại: epoch = monoUs + offsetUs + drift * (monoUs - anchorMonoUs)
+static bool synced = false;
+static int64_t offsetUs = 0;
+static uint64_t anchorMonoUs = 0;
+static float driftPpm = 0;
+static bool driftEstimated = false;
+static uint32_t syncCount = 0;
+
+uint64_t monotonicUs() {
+#if defined(ESP32)
+    return (uint64_t)esp_timer_get_time();
+#else
+    return (uint64_t)micros(); // host: unsigned long 64-bit, không tràn
+#endif
+}
+
+void timeBaseOnSync(int64_t epochUs, uint64_t monoUs) {
+    if (syncPending.load(std::memory_order_acquire)) return; // mẫu trước chưa xử lý, bỏ mẫu này
+    pendingEpochUs = epochUs;
+    pendingMonoUs = monoUs;
+    syncPending.store(true, std::memory_order_release);
+}
+
+void timeBaseLoop() {
+    if (!syncPending.load(std::memory_order_acquire)) return;
+    int64_t epochUs = pendingEpochUs;
+    uint64_t monoUs = pendingMonoUs;
+    syncPending.store(false, std::memory_order_release);
+
+    int64_t newOffset = epochUs - (int64_t)monoUs;
+    if (synced && monoUs - anchorMonoUs >= DRIFT_MIN_INTERVAL_US) {
+        // Offset dự đoán bởi mô hình cũ so với offset đo được → sai số tần số
+        int64_t predicted = offsetUs + (int64_t)(driftPpm * 1e-6f * (float)(monoUs - anchorMonoUs));
+        float errorPpm = (float)(newOffset - predicted) * 1e6f / (float)(monoUs - anchorMonoUs);
+        driftPpm += (driftEstimated ? DRIFT_ALPHA : 1.0f) * errorPpm; // lần đầu lấy nguyên giá trị
+        driftEstimated = true;
+        if (driftPpm > DRIFT_MAX_PPM) driftPpm = DRIFT_MAX_PPM;
+        if (driftPpm < -DRIFT_MAX_PPM) driftPpm = -DRIFT_MAX_PPM;
+    }
+
+    offsetUs = newOffset;
+    anchorMonoUs = monoUs;
+    synced = true;
+    syncCount++;
+    LOG_I("[TIME] SNTP sync #%lu, drift=%.1f ppm", (unsigned long)syncCount, driftPpm);
+}
+
+bool timeBaseSynced() { return synced; }
+bool timeBaseValid() { return synced || time(nullptr) >= MIN_VALID_EPOCH_S; }
+
+int64_t toEpochMs(uint64_t monoUs) {
+    if (!synced) {
+        // Chưa có SNTP: dùng đồng hồ hệ thống trừ đi tuổi của bản ghi
+        int64_t ageUs = (int64_t)(monotonicUs() - monoUs);
+        return (int64_t)time(nullptr) * 1000 - ageUs / 1000;
+    }
+    int64_t elapsed = (int64_t)(monoUs - anchorMonoUs); // âm nếu đo trước lần sync gần nhất
+    int64_t correction = (int64_t)(driftPpm * 1e-6f * (float)elapsed);
+    return ((int64_t)monoUs + offsetUs + correction) / 1000;
+}
+
+float timeBaseDriftPpm() { return driftPpm; }
+uint32_t timeBaseSyncCount() { return syncCount; }
@@ -0,0 +1,25 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+// Mốc thời gian cho dữ liệu cảm biến.
+// Bản ghi chỉ lưu bộ đếm đơn điệu (micro giây từ lúc boot) tại thời điểm đo; giờ thực (epoch ms)
+// được tính lúc đóng gói từ offset do SNTP hiệu chỉnh liên tục, nên dữ liệu nằm trong buffer
+// hay gửi lại sau khi mất mạng vẫn giữ đúng thời điểm đo.
+
+uint64_t monotonicUs(); // không bị tràn, không bị ảnh hưởng khi đồng hồ hệ thống bị chỉnh
+
+// Ghi nhận một mẫu đồng bộ (có thể gọi từ callback SNTP ở task khác, chỉ lưu tạm)
+void timeBaseOnSync(int64_t epochUs, uint64_t monoUs);
+void timeBaseLoop();     // xử lý mẫu đồng bộ đang chờ, gọi trong loop()
+
+bool timeBaseSynced();
+// Giờ thực dùng được: đã SNTP, hoặc đồng hồ hệ thống đã đúng từ trước (giữ qua deep sleep/reset mềm).
+// false → toEpochMs() chỉ là giờ ~1970, bản ghi phải gắn "synced":false
+bool timeBaseValid();
+int64_t toEpochMs(uint64_t monoUs); // epoch ms tương ứng thời điểm monoUs
+float timeBaseDriftPpm();           // độ lệch tần số ước lượng của thạch anh
+uint32_t timeBaseSyncCount();
+
+#endif
@@ -0,0 +1,33 @@
+// OLEDDisplay::updateData() vẽ vào buffer U8g2 (bus I2C giả trong tools/host/Wire.h)
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "display/OLEDDisplay.h"
+
+static OLEDDisplay& display() {
+    static OLEDDisplay oled;
+    static bool started = false;
+    if (!started) {
+        oled.begin();
+        started = true;
+    }
+    return oled;
+}
+
+// range(0): 0 = bình thường, 1 = cảnh báo gas, 2 = cảnh báo cháy
+static void BM_OLEDUpdateData(benchmark::State& state) {
+    OLEDDisplay& oled = display();
+    const bool gasDanger = state.range(0) == 1;
+    const bool fireDanger = state.range(0) == 2;
+    float temp = 28.4f;
+
+    oled.updateData(temp, 61.2f, 412, gasDanger, fireDanger); // cùng trạng thái, không đo nhánh reset
+    unsigned long bytesBefore = Wire.bytesWritten;
+    for (auto _ : state) {
+        temp = temp > 30 ? 28.4f : temp + 0.1f; // giá trị đổi như dữ liệu thật
+        oled.updateData(temp, 61.2f, 412, gasDanger, fireDanger);
+    }
+    state.counters["i2c_bytes"] = benchmark::Counter(
+        (double)(Wire.bytesWritten - bytesBefore), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_OLEDUpdateData)->Arg(0)->Arg(1)->Arg(2);
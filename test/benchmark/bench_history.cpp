@@ -0,0 +1,75 @@
+// Lịch sử nén Gorilla: ghi 1 điểm, đọc biểu đồ OLED, giải nén cả 24 giờ (truy vấn MQTT)
+#include <benchmark/benchmark.h>
+#include <math.h>
+#include "history/HistoryStore.h"
+#include "sensors/Smoothing.h"
+
+// Dữ liệu giống firmware: DHT11 trả số nguyên, qua EMA như loop(); gas dao động ±5 quanh 400
+static void fillDay(HistoryStore& store, uint32_t points) {
+    float temp = 27, hum = 60, gas = 400;
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < points; i++) {
+        seed = seed * 1103515245 + 12345;
+        temp = emaUpdate(temp, roundf(28 + 2 * sinf(i / 200.0f)), 0.2f);
+        hum = emaUpdate(hum, roundf(60 + 5 * sinf(i / 300.0f)), 0.2f);
+        gas = emaUpdate(gas, 395 + (seed >> 16) % 11, 0.2f);
+        float values[GORILLA_CHANNELS] = {temp, hum, roundf(gas)};
+        store.add(1760000000 + i * 60, values);
+    }
+}
+
+static void BM_HistoryAppend(benchmark::State& state) {
+    static HistoryStore store;
+    float values[GORILLA_CHANNELS] = {28.4f, 61.2f, 412};
+    uint32_t ts = 1760000000;
+    for (auto _ : state) {
+        values[0] += 0.1f;
+        if (values[0] > 30) values[0] = 26;
+        bool closed = store.add(ts, values);
+        benchmark::DoNotOptimize(closed);
+        ts += 60;
+    }
+}
+BENCHMARK(BM_HistoryAppend);
+
+// Trang biểu đồ: 120 điểm gần nhất của một kênh
+static void BM_HistoryLatest120(benchmark::State& state) {
+    static HistoryStore store;
+    static bool filled = false;
+    if (!filled) {
+        fillDay(store, 24 * 60);
+        filled = true;
+    }
+    float out[120];
+    for (auto _ : state) {
+        size_t n = store.latest(0, out, 120);
+        benchmark::DoNotOptimize(n);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_HistoryLatest120);
+
+// Giải nén toàn bộ 24 giờ; counter bytes_per_point là tỉ lệ nén thực tế
+static void BM_HistoryDecode24h(benchmark::State& state) {
+    static HistoryStore store;
+    static bool filled = false;
+    if (!filled) {
+        fillDay(store, 24 * 60);
+        filled = true;
+    }
+    uint32_t ts;
+    float values[GORILLA_CHANNELS];
+    for (auto _ : state) {
+        for (uint8_t i = 0; i < store.blockCount(); i++) {
+            const GorillaBlock& b = store.block(i);
+            GorillaReader reader(b.data(), b.bitLength(), b.count());
+            while (reader.next(ts, values)) benchmark::DoNotOptimize(values);
+        }
+    }
+    HistoryStats s = store.stats();
+    state.SetItemsProcessed(state.iterations() * s.points);
+    state.counters["points"] = s.points;
+    state.counters["bytes"] = s.bytes;
+    state.counters["bytes_per_point"] = (double)s.bytes / s.points;
+}
+BENCHMARK(BM_HistoryDecode24h);
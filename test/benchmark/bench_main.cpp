@@ -0,0 +1,15 @@
+// Benchmark các đường nóng của firmware, chạy trên PC (env native "bench" trong platformio.ini).
+// Xem test/benchmark/README.md để chạy và so sánh với baseline.
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+
+int main(int argc, char** argv) {
+    Serial.setQuiet(true); // log không làm nhiễu kết quả
+    hostSkipDelays(true);  // delay() của code firmware không tính vào thời gian đo
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Lọc EMA trong loop() và hysteresis của MQ2Sensor::isDanger()
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include "sensors/Smoothing.h"
+#include "sensors/MQ2Sensor.h"
+
+// ------------------ EMA ------------------
+// Ba kênh như loop(): nhiệt độ, độ ẩm, gas
+static void BM_EmaSmoothing(benchmark::State& state) {
+    // Mẫu đọc thay đổi theo vòng lặp để compiler không gộp phép tính thành hằng
+    static const float temps[8] = {25.1f, 25.3f, 25.2f, 25.6f, 25.4f, 25.5f, 25.3f, 25.7f};
+    static const float hums[8] = {60.2f, 60.8f, 61.1f, 60.5f, 60.9f, 61.4f, 61.0f, 60.7f};
+    static const int gases[8] = {402, 415, 398, 420, 407, 411, 399, 418};
+    float tempSmooth = 25, humSmooth = 60, gasSmooth = 400;
+    const float alpha = 0.2;
+    unsigned i = 0;
+    for (auto _ : state) {
+        tempSmooth = emaUpdate(tempSmooth, temps[i & 7], alpha);
+        humSmooth = emaUpdate(humSmooth, hums[i & 7], alpha);
+        gasSmooth = emaUpdate(gasSmooth, gases[i & 7], alpha);
+        i++;
+        benchmark::DoNotOptimize(tempSmooth);
+        benchmark::DoNotOptimize(humSmooth);
+        benchmark::DoNotOptimize(gasSmooth);
+    }
+}
+BENCHMARK(BM_EmaSmoothing);
+
+// ------------------ MQ2 HYSTERESIS ------------------
+static const uint8_t MQ2_PIN = 34;
+static const uint16_t MQ2_BASE = 300;
+static const uint16_t MQ2_THRESHOLD = 400;
+
+// MQ2 đã warm-up và hiệu chỉnh với mức nền MQ2_BASE
+static MQ2Sensor makeCalibratedMQ2() {
+    MQ2Sensor mq2(MQ2_PIN, MQ2_THRESHOLD);
+    hostSetAnalog(MQ2_PIN, MQ2_BASE);
+    mq2.begin();
+    hostAdvanceTime(5000); // bỏ qua 5 giây làm nóng
+    mq2.update();
+    return mq2;
+}
+
+// range(0): 0 = dưới ngưỡng, 1 = trên ngưỡng, 2 = nhiễu quanh ngưỡng (đổi mỗi lần đọc)
+static void BM_MQ2IsDanger(benchmark::State& state) {
+    MQ2Sensor mq2 = makeCalibratedMQ2();
+    const uint16_t low = MQ2_BASE + MQ2_THRESHOLD / 2;
+    const uint16_t high = MQ2_BASE + MQ2_THRESHOLD + 50;
+    const int mode = state.range(0);
+    bool toggle = false;
+
+    hostSetAnalog(MQ2_PIN, mode == 1 ? high : low);
+    for (auto _ : state) {
+        if (mode == 2) {
+            toggle = !toggle;
+            hostSetAnalog(MQ2_PIN, toggle ? high : low);
+        }
+        bool danger = mq2.isDanger();
+        benchmark::DoNotOptimize(danger);
+    }
+}
+BENCHMARK(BM_MQ2IsDanger)->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,82 @@
+// Đóng gói JSON và queue gửi dữ liệu (publishQueue / sendSensorData)
+#include <benchmark/benchmark.h>
+#include "telemetry/SensorData.h"
+#include "telemetry/TelemetryQueue.h"
+#include "telemetry/TimeBase.h"
+
+static SensorData sample(DataPriority priority = PRIORITY_ROUTINE) {
+    SensorData data = {28.4f, 61.2f, 412, false, false, priority, monotonicUs()};
+    return data;
+}
+
+// ------------------ SERIALIZE ------------------
+static void BM_SerializeSensorData(benchmark::State& state) {
+    SensorData data = sample();
+    char payload[300];
+    for (auto _ : state) {
+        size_t n = serializeSensorData(data, "ESP32_01", payload, sizeof(payload));
+        benchmark::DoNotOptimize(n);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * serializeSensorData(data, "ESP32_01", payload, sizeof(payload)));
+}
+BENCHMARK(BM_SerializeSensorData);
+
+// ------------------ QUEUE THƯỜNG ------------------
+// Mỗi lần lặp làm đầy rồi xả hết queue: đủ dài để đo ổn định, có cả wrap-around
+static void BM_QueuePushPop(benchmark::State& state) {
+    TelemetryQueue queue;
+    SensorData in = sample(), out;
+    for (auto _ : state) {
+        while (queue.push(in)) {}
+        while (queue.pop(out)) benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * (DATA_QUEUE_SIZE - 1)); // queue vòng chứa tối đa N-1
+}
+BENCHMARK(BM_QueuePushPop);
+
+// Queue đầy (mất mạng): push bị từ chối phải vẫn rẻ
+static void BM_QueuePushFull(benchmark::State& state) {
+    TelemetryQueue queue;
+    SensorData in = sample();
+    while (queue.push(in)) {}
+    for (auto _ : state) {
+        for (int i = 0; i < 16; i++) {
+            bool ok = queue.push(in);
+            benchmark::DoNotOptimize(ok);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_QueuePushFull);
+
+// ------------------ LÀN ALARM ------------------
+// Ghi đè khi đầy (gấp đôi sức chứa) rồi peek/drop đến rỗng
+static void BM_AlarmPushPeekDrop(benchmark::State& state) {
+    TelemetryQueue queue;
+    SensorData in = sample(PRIORITY_ALARM);
+    const SensorData* head;
+    for (auto _ : state) {
+        for (int i = 0; i < 2 * ALARM_QUEUE_SIZE; i++) queue.pushAlarm(in);
+        while ((head = queue.peekAlarm()) != nullptr) {
+            benchmark::DoNotOptimize(head);
+            queue.dropAlarm();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * ALARM_QUEUE_SIZE);
+}
+BENCHMARK(BM_AlarmPushPeekDrop);
+
+// Một lượt publishQueue() không tính mạng: pop + serialize
+static void BM_PublishPath(benchmark::State& state) {
+    TelemetryQueue queue;
+    SensorData in = sample(), out;
+    char payload[300];
+    for (auto _ : state) {
+        queue.push(in);
+        queue.pop(out);
+        size_t n = serializeSensorData(out, "ESP32_01", payload, sizeof(payload));
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(BM_PublishPath);
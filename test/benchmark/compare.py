@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""So sánh kết quả Google Benchmark (JSON) với baseline, exit 1 nếu có benchmark chậm hơn quá ngưỡng.
+
+    .pio/build/bench/program --benchmark_repetitions=10 --benchmark_display_aggregates_only=true \
+        --benchmark_out=bench.json --benchmark_out_format=json
+    python3 test/benchmark/compare.py bench.json                 # so với baseline.json
+    python3 test/benchmark/compare.py bench.json --tolerance 0.2 # cho phép chậm hơn 20%
+    python3 test/benchmark/compare.py bench.json --update        # ghi kết quả mới làm baseline
+
+Baseline phụ thuộc máy: tạo lại bằng --update trên chính máy/CI dùng để so sánh.
+Benchmark không có trong baseline (hoặc có trong baseline mà không chạy/lỗi) cũng làm gate fail:
+đường nóng chưa có mốc thì không được coi là "đã kiểm". Ngoại lệ duy nhất là mục "excluded" trong
+baseline.json (tên → lý do): được in ra nhưng không tính, và --update tự xóa khi đã ghi được mốc.
+"""
+import argparse
+import json
+import os
+import sys
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json")
+TIME_SCALE = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(path, metric):
+    """Trả về {tên benchmark: thời gian ns/lần lặp}.
+
+    Có nhiều lần lặp (--benchmark_repetitions) → lấy min: nhiễu từ OS/máy ảo chỉ làm chậm đi,
+    nên min ổn định hơn mean/median. Chỉ có aggregate → dùng median.
+    """
+    with open(path) as f:
+        doc = json.load(f)
+
+    medians, runs, errors = {}, {}, set()
+    for b in doc.get("benchmarks", []):
+        if b.get("error_occurred"):
+            errors.add(b.get("run_name", b["name"]))
+            continue
+        t = b[metric] * TIME_SCALE[b.get("time_unit", "ns")]
+        name = b.get("run_name", b["name"])
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[name] = t
+        else:
+            runs.setdefault(name, []).append(t)
+
+    times = {name: min(ts) for name, ts in runs.items()}
+    for name, t in medians.items():
+        times.setdefault(name, t)
+    return doc, times, errors - set(times)
+
+
+def load_excluded(path):
+    """Benchmark được loại khỏi gate có chủ đích: {tên: lý do} trong baseline.json."""
+    if not os.path.exists(path):
+        return {}
+    with open(path) as f:
+        return json.load(f).get("excluded", {})
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("current", help="JSON từ --benchmark_out")
+    ap.add_argument("--baseline", default=DEFAULT_BASELINE)
+    ap.add_argument("--tolerance", type=float, default=0.20, help="tỉ lệ chậm hơn cho phép (mặc định 0.20)")
+    ap.add_argument("--metric", choices=["cpu_time", "real_time"], default="cpu_time")
+    ap.add_argument("--update", action="store_true", help="ghi đè baseline bằng kết quả hiện tại")
+    args = ap.parse_args()
+
+    doc, current, errors = load_times(args.current, args.metric)
+    if not current:
+        print("no benchmark results in %s" % args.current)
+        return 1
+
+    if args.update:
+        if errors:
+            print("not updating: benchmark(s) failed: %s" % ", ".join(sorted(errors)))
+            return 1
+        if doc.get("context", {}).get("library_build_type") == "debug":
+            print("warning: Google Benchmark library is a debug build, timings include its overhead")
+        # Chỉ giữ 1 giá trị (min) mỗi benchmark cho cả 2 metric, file baseline gọn để review
+        other = "real_time" if args.metric == "cpu_time" else "cpu_time"
+        _, other_times, _ = load_times(args.current, other)
+        excluded = {n: r for n, r in load_excluded(args.baseline).items() if n not in current}
+        baseline_doc = {
+            "context": doc.get("context", {}),
+            "excluded": excluded,
+            "benchmarks": [{"name": name, "run_name": name, "run_type": "iteration",
+                            args.metric: round(current[name], 2),
+                            other: round(other_times.get(name, current[name]), 2),
+                            "time_unit": "ns"} for name in sorted(current)],
+        }
+        with open(args.baseline, "w") as f:
+            json.dump(baseline_doc, f, indent=2)
+            f.write("\n")
+        print("baseline updated: %s (%d benchmarks)" % (args.baseline, len(current)))
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print("no baseline at %s, run with --update first" % args.baseline)
+        return 1
+    _, baseline, _ = load_times(args.baseline, args.metric)
+    excluded = load_excluded(args.baseline)
+
+    regressions = unchecked = 0
+    width = max(len(n) for n in set(current) | set(baseline))
+    print("%-*s %12s %12s %8s" % (width, "benchmark", "baseline ns", "current ns", "change"))
+    for name in sorted(current):
+        cur = current[name]
+        if name not in baseline and name in excluded:
+            print("%-*s %12s %12.1f %8s  EXCLUDED: %s" % (width, name, "-", cur, "-", excluded[name]))
+            continue
+        if name not in baseline:
+            print("%-*s %12s %12.1f %8s  NO BASELINE" % (width, name, "-", cur, "new"))
+            unchecked += 1
+            continue
+        base = baseline[name]
+        change = (cur - base) / base if base > 0 else 0.0
+        status = ""
+        if change > args.tolerance:
+            status = "  REGRESSION"
+            regressions += 1
+        print("%-*s %12.1f %12.1f %+7.1f%%%s" % (width, name, base, cur, change * 100, status))
+
+    for name in sorted(set(baseline) - set(current)):
+        print("%-*s %12.1f %12s %8s  %s" % (width, name, baseline[name], "-", "missing",
+                                          "ERROR" if name in errors else "NOT RUN"))
+        unchecked += 1
+
+    if regressions:
+        print("\n%d benchmark(s) slower than baseline by more than %.0f%%" % (regressions, args.tolerance * 100))
+    if excluded:
+        print("\n%d benchmark(s) excluded from the gate in %s" % (len(excluded), os.path.basename(args.baseline)))
+    if unchecked:
+        print("\n%d benchmark(s) not compared: record them with --update or fix the run" % unchecked)
+    if regressions or unchecked:
+        return 1
+    print("\nOK: no regression beyond %.0f%%" % (args.tolerance * 100))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,361 @@
+// fleet_sim — bộ sinh tải đội thiết bị ảo cho backend MQTT.
+//
+// Mỗi thiết bị ảo dùng đúng đường publish của firmware: TelemetryQueue (queue thường
+// + làn alarm), publishTelemetry() (thứ tự xả queue), serializeSensorData() và PubSubClient,
+// chạy trên transport host (tools/host). Thiết bị được chia đều cho N worker thread, mỗi thread là một event
+// loop không block duyệt qua các thiết bị của nó.
+//
+//   fleet_sim --devices 2000 --threads 8 --duration 60 --broker 127.0.0.1:1883
+//   fleet_sim --devices 10000 --broker loopback     (broker giả trong process)
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <PubSubClient.h>
+#include "telemetry/TelemetryQueue.h"
+#include "telemetry/TelemetryPublisher.h"
+#include "telemetry/TimeBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// ------------------ CẤU HÌNH ------------------
+struct SensorProfile {
+    const char* name;
+    float tempBase, tempNoise;
+    float humBase, humNoise;
+    int gasBase, gasNoise;
+    float alarmsPerHour; // tần suất chùm cảnh báo (gas/lửa)
+};
+
+static const SensorProfile PROFILES[] = {
+    {"bedroom", 27.0f, 0.3f, 60.0f, 1.0f, 180, 10, 0.5f},
+    {"kitchen", 31.0f, 1.0f, 70.0f, 3.0f, 320, 60, 4.0f},
+    {"garage",  33.0f, 2.0f, 55.0f, 5.0f, 250, 120, 2.0f},
+};
+static const int PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+struct FleetConfig {
+    int devices = 1000;
+    int threads = 4;
+    int durationSec = 30;
+    std::string brokerHost = "loopback";
+    uint16_t brokerPort = 1883;
+    std::string topic = "esp32/pub";
+    const char* profile = "mixed";   // tên profile hoặc "mixed"
+    unsigned long sampleMs = 1000;   // chu kỳ đọc cảm biến
+    unsigned long publishMs = 1000;  // PUBLISH_INTERVAL của firmware
+    unsigned long rampMs = 3000;     // dàn đều thời điểm kết nối ban đầu
+    float outagesPerHour = 2.0f;     // mất kết nối ngẫu nhiên
+    unsigned long outageMs = 10000;  // thời gian mất kết nối trung bình
+    unsigned long alarmBurstMs = 8000;
+    float alarmScale = 1.0f;         // nhân tần suất alarm của profile
+};
+
+// ------------------ THIẾT BỊ ẢO ------------------
+struct SimDevice {
+    char id[16];
+    const SensorProfile* profile;
+    uint32_t rng;
+
+    WiFiClient net;
+    PubSubClient client;
+    TelemetryQueue queue;
+
+    unsigned long nextSampleMs;
+    unsigned long lastPublishMs;
+    unsigned long nextConnectMs;
+    unsigned long outageUntilMs;
+    unsigned long alarmUntilMs;
+    unsigned long lastStepMs;
+    bool lastDanger;
+};
+
+// Thống kê riêng cho từng worker, gộp lại khi kết thúc (không cần khoá)
+struct WorkerStats {
+    unsigned long published = 0;
+    unsigned long alarmsPublished = 0;
+    unsigned long publishFailed = 0;
+    unsigned long dropped = 0;
+    unsigned long reconnects = 0;
+    unsigned long connectFailed = 0;
+    unsigned long long bytes = 0;
+    std::vector<uint32_t> callUs;      // thời gian gọi client.publish()
+    std::vector<uint32_t> routineE2eUs; // capture → publish xong
+    std::vector<uint32_t> alarmE2eUs;
+};
+
+static uint32_t nextRand(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+static float randUnit(uint32_t& s) { return (nextRand(s) & 0xFFFFFF) / 16777216.0f; }
+static float randSigned(uint32_t& s) { return randUnit(s) * 2.0f - 1.0f; }
+
+// Xác suất xảy ra trong một khoảng dtMs với tần suất ratePerHour
+static bool chance(uint32_t& s, float ratePerHour, unsigned long dtMs) {
+    return randUnit(s) < ratePerHour * dtMs / 3600000.0f;
+}
+
+static const SensorProfile* findProfile(const char* name, int index) {
+    for (int i = 0; i < PROFILE_COUNT; i++)
+        if (strcmp(PROFILES[i].name, name) == 0) return &PROFILES[i];
+    return &PROFILES[index % PROFILE_COUNT]; // "mixed"
+}
+
+static void sampleDevice(SimDevice& d, const FleetConfig& cfg, unsigned long now, WorkerStats& st) {
+    const SensorProfile& p = *d.profile;
+
+    if (now >= d.alarmUntilMs && chance(d.rng, p.alarmsPerHour * cfg.alarmScale, cfg.sampleMs))
+        d.alarmUntilMs = now + cfg.alarmBurstMs / 2 + nextRand(d.rng) % cfg.alarmBurstMs;
+    bool danger = now < d.alarmUntilMs;
+    bool flame = danger && (nextRand(d.rng) & 1);
+
+    SensorData data;
+    data.temp = p.tempBase + p.tempNoise * randSigned(d.rng) + (flame ? 15.0f : 0.0f);
+    data.hum = p.humBase + p.humNoise * randSigned(d.rng);
+    data.gas = p.gasBase + (int)(p.gasNoise * randSigned(d.rng)) + (danger ? 600 : 0);
+    data.flame = flame;
+    data.danger = danger;
+    data.capturedUs = monotonicUs();
+
+    // Giống main.cpp: chuyển trạng thái nguy hiểm đi làn alarm, còn lại đi queue thường
+    if (danger != d.lastDanger) {
+        data.priority = PRIORITY_ALARM;
+        d.queue.pushAlarm(data);
+    } else {
+        data.priority = PRIORITY_ROUTINE;
+        if (!d.queue.push(data)) st.dropped++;
+    }
+    d.lastDanger = danger;
+}
+
+// Ngữ cảnh cho publishTelemetry(): thiết bị + thống kê của worker
+struct PublishCtx {
+    SimDevice* device;
+    const FleetConfig* cfg;
+    WorkerStats* stats;
+};
+
+static bool publishOne(const SensorData& data, void* arg) {
+    PublishCtx& ctx = *(PublishCtx*)arg;
+    SimDevice& d = *ctx.device;
+    WorkerStats& st = *ctx.stats;
+    bool alarm = data.priority == PRIORITY_ALARM;
+
+    char payload[300];
+    size_t len = serializeSensorData(data, d.id, payload, sizeof(payload));
+
+    uint64_t t0 = monotonicUs();
+    bool ok = d.client.publish(ctx.cfg->topic.c_str(), payload);
+    uint64_t t1 = monotonicUs();
+
+    if (!ok) {
+        st.publishFailed++;
+        return false;
+    }
+    st.callUs.push_back(t1 - t0);
+    (alarm ? st.alarmE2eUs : st.routineE2eUs).push_back(t1 - data.capturedUs);
+    st.bytes += len;
+    st.published++;
+    if (alarm) st.alarmsPublished++;
+    return true;
+}
+
+// Một bước của thiết bị, tương ứng loopAWS() + phần gửi dữ liệu trong loop()
+static void stepDevice(SimDevice& d, const FleetConfig& cfg, unsigned long now, WorkerStats& st) {
+    unsigned long dt = now - d.lastStepMs;
+    d.lastStepMs = now;
+
+    if (now < d.outageUntilMs) {
+        if (d.net.connected()) d.net.stop(); // rớt mạng: TCP chết, dữ liệu tiếp tục dồn vào queue
+    } else if (!d.client.connected()) {
+        if (now >= d.nextConnectMs) {
+            if (d.client.connect(d.id)) {
+                st.reconnects++;
+            } else {
+                st.connectFailed++;
+                d.nextConnectMs = now + 500; // CONNECT_RETRY_MS
+            }
+        }
+    } else {
+        d.client.loop();
+        if (chance(d.rng, cfg.outagesPerHour, dt))
+            d.outageUntilMs = now + cfg.outageMs / 2 + nextRand(d.rng) % cfg.outageMs;
+    }
+
+    if (now >= d.nextSampleMs) {
+        sampleDevice(d, cfg, now, st);
+        d.nextSampleMs += cfg.sampleMs;
+    }
+
+    if (!d.client.connected()) return;
+
+    // Cùng đường xả queue với aws_mqtt.cpp (alarm trước, dữ liệu thường theo publishMs)
+    PublishCtx ctx = {&d, &cfg, &st};
+    publishTelemetry(d.queue, now, d.lastPublishMs, cfg.publishMs, publishOne, &ctx);
+}
+
+static void runWorker(std::vector<SimDevice*> devices, const FleetConfig& cfg,
+                      unsigned long deadline, WorkerStats& st) {
+    while (millis() < deadline) {
+        unsigned long loopStart = millis();
+        for (SimDevice* d : devices) stepDevice(*d, cfg, millis(), st);
+        if (millis() == loopStart) delay(1); // nhường CPU khi vòng lặp quá nhanh
+    }
+    for (SimDevice* d : devices) d->client.disconnect();
+}
+
+// ------------------ BÁO CÁO ------------------
+static uint32_t percentile(std::vector<uint32_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void printLatency(const char* name, std::vector<uint32_t>& v) {
+    if (v.empty()) {
+        printf("  %-22s (none)\n", name);
+        return;
+    }
+    uint32_t p50 = percentile(v, 0.50);
+    uint32_t p99 = percentile(v, 0.99);
+    uint32_t mx = *std::max_element(v.begin(), v.end());
+    printf("  %-22s p50=%9.3f ms  p99=%9.3f ms  max=%9.3f ms  (n=%zu)\n", name,
+           p50 / 1000.0, p99 / 1000.0, mx / 1000.0, v.size());
+}
+
+static long readRssKb() {
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    long pages = 0, resident = 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void usage() {
+    printf("usage: fleet_sim [--devices N] [--threads N] [--duration SEC]\n"
+           "                 [--broker HOST:PORT|loopback] [--topic T]\n"
+           "                 [--profile bedroom|kitchen|garage|mixed]\n"
+           "                 [--sample-ms MS] [--publish-ms MS] [--ramp-ms MS]\n"
+           "                 [--outages-per-hour F] [--outage-ms MS]\n"
+           "                 [--alarm-scale F] [--alarm-burst-ms MS]\n");
+}
+
+static bool parseArgs(int argc, char** argv, FleetConfig& cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h" || i + 1 >= argc) return false;
+        const char* v = argv[++i];
+        if (a == "--devices") cfg.devices = atoi(v);
+        else if (a == "--threads") cfg.threads = atoi(v);
+        else if (a == "--duration") cfg.durationSec = atoi(v);
+        else if (a == "--topic") cfg.topic = v;
+        else if (a == "--profile") cfg.profile = v;
+        else if (a == "--sample-ms") cfg.sampleMs = strtoul(v, nullptr, 10);
+        else if (a == "--publish-ms") cfg.publishMs = strtoul(v, nullptr, 10);
+        else if (a == "--ramp-ms") cfg.rampMs = strtoul(v, nullptr, 10);
+        else if (a == "--outages-per-hour") cfg.outagesPerHour = (float)atof(v);
+        else if (a == "--outage-ms") cfg.outageMs = strtoul(v, nullptr, 10);
+        else if (a == "--alarm-scale") cfg.alarmScale = (float)atof(v);
+        else if (a == "--alarm-burst-ms") cfg.alarmBurstMs = strtoul(v, nullptr, 10);
+        else if (a == "--broker") {
+            std::string b = v;
+            size_t colon = b.rfind(':');
+            cfg.brokerHost = b.substr(0, colon);
+            if (colon != std::string::npos) cfg.brokerPort = (uint16_t)atoi(b.c_str() + colon + 1);
+        } else return false;
+    }
+    return cfg.devices > 0 && cfg.threads > 0 && cfg.durationSec > 0 &&
+           cfg.sampleMs > 0 && cfg.outageMs > 0 && cfg.alarmBurstMs > 0;
+}
+
+int main(int argc, char** argv) {
+    FleetConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        usage();
+        return 1;
+    }
+
+    long rssBefore = readRssKb();
+    std::vector<std::unique_ptr<SimDevice>> fleet;
+    fleet.reserve(cfg.devices);
+    unsigned long start = millis();
+    for (int i = 0; i < cfg.devices; i++) {
+        std::unique_ptr<SimDevice> d(new SimDevice());
+        snprintf(d->id, sizeof(d->id), "SIM_%06d", i);
+        d->profile = findProfile(cfg.profile, i);
+        d->rng = 0x9E3779B9u ^ (uint32_t)(i * 2654435761u);
+        if (d->rng == 0) d->rng = 1;
+        d->client.setClient(d->net);
+        d->client.setServer(cfg.brokerHost.c_str(), cfg.brokerPort);
+        d->nextConnectMs = start + nextRand(d->rng) % (cfg.rampMs + 1);
+        d->nextSampleMs = start + nextRand(d->rng) % cfg.sampleMs;
+        d->lastPublishMs = start;
+        d->outageUntilMs = 0;
+        d->alarmUntilMs = 0;
+        d->lastStepMs = start;
+        d->lastDanger = false;
+        fleet.push_back(std::move(d));
+    }
+    long rssAfter = readRssKb();
+
+    printf("fleet_sim: %d devices, %d threads, %d s, broker %s:%u, profile %s\n",
+           cfg.devices, cfg.threads, cfg.durationSec, cfg.brokerHost.c_str(),
+           cfg.brokerPort, cfg.profile);
+
+    std::vector<WorkerStats> stats(cfg.threads);
+    std::vector<std::thread> workers;
+    unsigned long runStart = millis();
+    unsigned long deadline = runStart + cfg.durationSec * 1000UL;
+    for (int t = 0; t < cfg.threads; t++) {
+        std::vector<SimDevice*> mine;
+        for (int i = t; i < cfg.devices; i += cfg.threads) mine.push_back(fleet[i].get());
+        workers.emplace_back(runWorker, std::move(mine), std::cref(cfg), deadline, std::ref(stats[t]));
+    }
+    for (std::thread& w : workers) w.join();
+    double elapsed = (millis() - runStart) / 1000.0;
+
+    WorkerStats total;
+    for (WorkerStats& s : stats) {
+        total.published += s.published;
+        total.alarmsPublished += s.alarmsPublished;
+        total.publishFailed += s.publishFailed;
+        total.dropped += s.dropped;
+        total.reconnects += s.reconnects;
+        total.connectFailed += s.connectFailed;
+        total.bytes += s.bytes;
+        total.callUs.insert(total.callUs.end(), s.callUs.begin(), s.callUs.end());
+        total.routineE2eUs.insert(total.routineE2eUs.end(), s.routineE2eUs.begin(), s.routineE2eUs.end());
+        total.alarmE2eUs.insert(total.alarmE2eUs.end(), s.alarmE2eUs.begin(), s.alarmE2eUs.end());
+    }
+
+    printf("\nThroughput\n");
+    printf("  published              %lu (%lu alarms)\n", total.published, total.alarmsPublished);
+    printf("  sustained              %.1f msgs/s, %.1f KB/s payload\n",
+           total.published / elapsed, total.bytes / elapsed / 1024.0);
+    printf("  queue drops            %lu\n", total.dropped);
+    printf("  publish failures       %lu\n", total.publishFailed);
+    printf("  connects / failures    %lu / %lu\n", total.reconnects, total.connectFailed);
+
+    printf("\nLatency\n");
+    printLatency("publish() call", total.callUs);
+    printLatency("routine capture->sent", total.routineE2eUs);
+    printLatency("alarm capture->sent", total.alarmE2eUs);
+
+    printf("\nMemory per device\n");
+    printf("  sizeof(SimDevice)      %zu B (TelemetryQueue %zu B)\n", sizeof(SimDevice), sizeof(TelemetryQueue));
+    printf("  MQTT buffer            %u B\n", fleet.empty() ? 0 : fleet[0]->client.getBufferSize());
+    printf("  RSS delta              %.1f B\n", (rssAfter - rssBefore) * 1024.0 / cfg.devices);
+    return 0;
+}
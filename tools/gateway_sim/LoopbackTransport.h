@@ -0,0 +1,60 @@
+// LoopbackTransport — "sóng radio" trong process: mọi transport cùng bus thấy frame của nhau.
+// Dùng để đo riêng chi phí của gateway (giải mã, bỏ trùng, gom lô, serialize) không có I/O.
+#ifndef LOOPBACKTRANSPORT_H
+#define LOOPBACKTRANSPORT_H
+
+#include "gateway/LinkTransport.h"
+#include <string.h>
+
+#define LOOPBACK_BUS_FRAMES 4096
+
+struct LoopbackBus {
+    LinkFrame frames[LOOPBACK_BUS_FRAMES];
+    size_t head = 0;
+    size_t count = 0;
+    unsigned long overflows = 0; // bus đầy, tương đương hàng đợi RX của ESP-NOW tràn
+};
+
+class LoopbackTransport : public LinkTransport {
+  public:
+    LoopbackTransport(LoopbackBus& b, uint32_t address) : bus(b), addr(address) {}
+
+    // Địa chỉ 6 byte như MAC: 2 byte 0 rồi address (big-endian), nên nodeIdFromAddress() == address
+    static void linkAddress(uint32_t address, uint8_t out[6]) {
+        out[0] = out[1] = 0;
+        out[2] = address >> 24;
+        out[3] = address >> 16;
+        out[4] = address >> 8;
+        out[5] = address;
+    }
+
+    bool begin() override { return true; }
+
+    bool send(const uint8_t* data, size_t len) override {
+        if (len > LINK_MAX_FRAME) return false;
+        if (bus.count >= LOOPBACK_BUS_FRAMES) {
+            bus.overflows++;
+            return true;
+        }
+        LinkFrame& f = bus.frames[(bus.head + bus.count) % LOOPBACK_BUS_FRAMES];
+        linkAddress(addr, f.src);
+        f.len = len;
+        memcpy(f.data, data, len);
+        bus.count++;
+        return true;
+    }
+
+    bool receive(LinkFrame& frame) override {
+        if (bus.count == 0) return false;
+        frame = bus.frames[bus.head];
+        bus.head = (bus.head + 1) % LOOPBACK_BUS_FRAMES;
+        bus.count--;
+        return true;
+    }
+
+  private:
+    LoopbackBus& bus;
+    uint32_t addr;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "UdpTransport.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpTransport::UdpTransport(uint16_t bp, const std::string& host, uint16_t dp)
+    : fd(-1), bindPort(bp), destHost(host), destPort(dp) {
+    static_assert(sizeof(sockaddr_in) <= sizeof(dest), "sockaddr_in");
+}
+
+UdpTransport::~UdpTransport() {
+    if (fd >= 0) close(fd);
+}
+
+bool UdpTransport::linkAddress(const std::string& host, uint16_t port, uint8_t out[6]) {
+    in_addr ip;
+    if (inet_pton(AF_INET, host.c_str(), &ip) != 1) return false;
+    uint16_t p = htons(port);
+    memcpy(out, &ip, 4);
+    memcpy(out + 4, &p, 2);
+    return true;
+}
+
+bool UdpTransport::begin() {
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    sockaddr_in* to = (sockaddr_in*)dest;
+    memset(to, 0, sizeof(*to));
+    to->sin_family = AF_INET;
+    to->sin_port = htons(destPort);
+    if (inet_pton(AF_INET, destHost.c_str(), &to->sin_addr) != 1) return false;
+
+    if (bindPort == 0) return true;
+
+    int buf = 4 * 1024 * 1024; // gateway: buffer nhận lớn, giống hàng đợi RX của ESP-NOW
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(bindPort);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    return bind(fd, (sockaddr*)&local, sizeof(local)) == 0;
+}
+
+bool UdpTransport::send(const uint8_t* data, size_t len) {
+    if (len > LINK_MAX_FRAME) return false;
+    return sendto(fd, data, len, 0, (sockaddr*)dest, sizeof(sockaddr_in)) == (ssize_t)len;
+}
+
+bool UdpTransport::receive(LinkFrame& frame) {
+    sockaddr_in from;
+    socklen_t fromLen = sizeof(from);
+    ssize_t n = recvfrom(fd, frame.data, sizeof(frame.data), 0, (sockaddr*)&from, &fromLen);
+    if (n <= 0) return false;
+
+    frame.len = (uint8_t)n;
+    memcpy(frame.src, &from.sin_addr, 4); // IP:port thay cho MAC
+    memcpy(frame.src + 4, &from.sin_port, 2);
+    return true;
+}
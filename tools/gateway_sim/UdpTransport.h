@@ -0,0 +1,29 @@
+// UdpTransport — leaf/gateway qua UDP trên host (127.0.0.1 hoặc LAN), không chặn
+#ifndef UDPTRANSPORT_H
+#define UDPTRANSPORT_H
+
+#include "gateway/LinkTransport.h"
+#include <string>
+
+class UdpTransport : public LinkTransport {
+  public:
+    // bindPort = 0: chỉ gửi (leaf); destHost:destPort là gateway
+    UdpTransport(uint16_t bindPort, const std::string& destHost, uint16_t destPort);
+    ~UdpTransport();
+
+    // Địa chỉ 6 byte gateway thấy trong LinkFrame.src (IPv4 rồi port, thứ tự mạng), để đăng ký leaf
+    static bool linkAddress(const std::string& host, uint16_t port, uint8_t out[6]);
+
+    bool begin() override;
+    bool send(const uint8_t* data, size_t len) override;
+    bool receive(LinkFrame& frame) override;
+
+  private:
+    int fd;
+    uint16_t bindPort;
+    std::string destHost;
+    uint16_t destPort;
+    uint8_t dest[16]; // sockaddr_in
+};
+
+#endif
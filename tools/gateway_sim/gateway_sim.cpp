@@ -0,0 +1,331 @@
+// gateway_sim — đo gateway ESP-NOW trên host: N leaf ảo gửi NodeFrame tới một Gateway thật
+// (src/gateway) qua transport loopback (trong process) hoặc UDP (127.0.0.1), uplink giả
+// chỉ đếm byte. So sánh với chế độ độc lập, nơi mỗi node tự giữ một phiên TLS/MQTT.
+//
+//   gateway_sim --transport loopback --nodes 64 --rate 0 --duration 5     (flood: trần CPU của gateway)
+//   gateway_sim --transport udp --nodes 16 --rate 1 --duration 30 --loss 0.05
+//   gateway_sim --nodes 16 --rate 2 --duration 20 --alarm-ratio 0.05 --outage 10  (uplink mất 10 s)
+//   gateway_sim --nodes 16 --rate 5 --duration 20 --reboot-every 4               (leaf khởi động lại)
+#include <Arduino.h>
+#include "gateway/Gateway.h"
+#include "gateway/LeafNode.h"
+#include "telemetry/TimeBase.h"
+#include "LoopbackTransport.h"
+#include "UdpTransport.h"
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// Một phiên mbedTLS + PubSubClient trên ESP32 (buffer vào/ra + context), đo trên firmware độc lập
+#define STANDALONE_TLS_BYTES (40 * 1024)
+#define SPOOF_FRAMES 5 // alarm giả gửi từ mỗi nguồn giả mạo lúc bắt đầu
+
+// ------------------ CẤU HÌNH ------------------
+struct SimConfig {
+    std::string transport = "loopback";
+    int nodes = 16;
+    float rate = 1.0f;          // bản ghi/giây mỗi leaf, 0 = gửi liên tục (flood)
+    int durationSec = 10;
+    float alarmRatio = 0.01f;   // tỉ lệ bản ghi là alarm (gửi lặp LEAF_ALARM_REPEATS lần)
+    float loss = 0.0f;          // tỉ lệ frame mất trên đường truyền
+    uint16_t port = 47000;      // cổng UDP của gateway
+    int outageSec = 0;          // uplink lỗi trong khoảng này, bắt đầu sau 1/4 thời gian chạy
+    int rebootSec = 0;          // mỗi leaf khởi động lại (seq về 0, boot mới) sau mỗi khoảng này
+};
+
+static uint32_t nextRand(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+static float randUnit(uint32_t& s) { return (nextRand(s) & 0xFFFFFF) / 16777216.0f; }
+static float randSigned(uint32_t& s) { return randUnit(s) * 2.0f - 1.0f; }
+
+// Bọc transport của leaf, bỏ frame theo xác suất (nhiễu, va chạm, ngoài vùng phủ)
+class LossyTransport : public LinkTransport {
+  public:
+    LossyTransport(LinkTransport& inner, float loss, uint32_t seed) : inner(inner), loss(loss), rng(seed) {}
+
+    bool begin() override { return inner.begin(); }
+    bool send(const uint8_t* data, size_t len) override {
+        if (loss > 0 && randUnit(rng) < loss) {
+            lost++;
+            return true; // broadcast không có ACK: leaf không biết frame đã mất
+        }
+        return inner.send(data, len);
+    }
+    bool receive(LinkFrame& frame) override { return inner.receive(frame); }
+
+    unsigned long lost = 0;
+
+  private:
+    LinkTransport& inner;
+    float loss;
+    uint32_t rng;
+};
+
+// ------------------ LEAF ẢO ------------------
+struct SimLeaf {
+    std::unique_ptr<LinkTransport> link;
+    std::unique_ptr<LossyTransport> lossy;
+    std::unique_ptr<LeafNode> node;
+    uint32_t id;
+    uint32_t rng;
+    uint64_t nextSendUs;
+    uint64_t nextRebootUs;
+};
+
+static void bootLeaf(SimLeaf& leaf) {
+    leaf.node.reset(new LeafNode(*leaf.lossy, leaf.id, (uint8_t)(nextRand(leaf.rng) % 255 + 1)));
+}
+
+static SensorData sampleLeaf(SimLeaf& leaf, const SimConfig& cfg) {
+    bool alarm = randUnit(leaf.rng) < cfg.alarmRatio;
+
+    SensorData data;
+    data.temp = 28.0f + randSigned(leaf.rng) + (alarm ? 15.0f : 0.0f);
+    data.hum = 60.0f + 3.0f * randSigned(leaf.rng);
+    data.gas = 250 + (int)(60 * randSigned(leaf.rng)) + (alarm ? 600 : 0);
+    data.flame = alarm && (nextRand(leaf.rng) & 1);
+    data.danger = alarm;
+    data.priority = alarm ? PRIORITY_ALARM : PRIORITY_ROUTINE;
+    data.capturedUs = monotonicUs();
+    return data;
+}
+
+static unsigned long handledFrames(const GatewayStats& s) { return s.frames + s.duplicates + s.invalid + s.rejected; }
+
+// ------------------ UPLINK GIẢ ------------------
+struct UplinkStats {
+    unsigned long batches = 0;
+    unsigned long long bytes = 0;
+    size_t maxPayload = 0;
+    uint64_t downFromUs = 0;    // cửa sổ mất uplink (MQTT rớt)
+    uint64_t downUntilUs = 0;
+    unsigned long refused = 0;
+};
+
+static bool countingUplink(const char* payload, size_t len, void* ctx) {
+    (void)payload;
+    UplinkStats& u = *(UplinkStats*)ctx;
+    uint64_t now = monotonicUs();
+    if (now >= u.downFromUs && now < u.downUntilUs) {
+        u.refused++;
+        return false;
+    }
+    u.batches++;
+    u.bytes += len;
+    if (len > u.maxPayload) u.maxPayload = len;
+    return true;
+}
+
+// ------------------ BÁO CÁO ------------------
+static void usage() {
+    printf("usage: gateway_sim [--transport loopback|udp] [--nodes N] [--rate HZ (0 = flood)]\n"
+           "                   [--duration SEC] [--alarm-ratio F] [--loss F] [--port P] [--outage SEC]\n"
+           "                   [--reboot-every SEC]\n");
+}
+
+static bool parseArgs(int argc, char** argv, SimConfig& cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--help" || a == "-h" || i + 1 >= argc) return false;
+        const char* v = argv[++i];
+        if (a == "--transport") cfg.transport = v;
+        else if (a == "--nodes") cfg.nodes = atoi(v);
+        else if (a == "--rate") cfg.rate = (float)atof(v);
+        else if (a == "--duration") cfg.durationSec = atoi(v);
+        else if (a == "--alarm-ratio") cfg.alarmRatio = (float)atof(v);
+        else if (a == "--loss") cfg.loss = (float)atof(v);
+        else if (a == "--port") cfg.port = (uint16_t)atoi(v);
+        else if (a == "--outage") cfg.outageSec = atoi(v);
+        else if (a == "--reboot-every") cfg.rebootSec = atoi(v);
+        else return false;
+    }
+    // Mất uplink phải kết thúc trước khi hết giờ để kiểm được alarm có lên hết không
+    return (cfg.transport == "loopback" || cfg.transport == "udp") && cfg.nodes > 0 &&
+           cfg.nodes <= GATEWAY_MAX_NODES && cfg.rate >= 0 && cfg.durationSec > 0 && cfg.outageSec >= 0 && cfg.rebootSec >= 0 &&
+           cfg.durationSec / 4.0 + cfg.outageSec < cfg.durationSec;
+}
+
+int main(int argc, char** argv) {
+    SimConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        usage();
+        return 1;
+    }
+
+    LoopbackBus bus;
+    std::unique_ptr<LinkTransport> gatewayLink;
+    if (cfg.transport == "udp") gatewayLink.reset(new UdpTransport(cfg.port, "127.0.0.1", 0));
+    else gatewayLink.reset(new LoopbackTransport(bus, 0));
+
+    UplinkStats uplink;
+    std::unique_ptr<Gateway> gateway(new Gateway(*gatewayLink, "GW_SIM", countingUplink, &uplink));
+    if (!gateway->begin()) {
+        printf("gateway transport init failed\n");
+        return 1;
+    }
+
+    std::vector<SimLeaf> leaves(cfg.nodes);
+    uint64_t start = monotonicUs();
+    for (int i = 0; i < cfg.nodes; i++) {
+        SimLeaf& l = leaves[i];
+        // Node ID suy từ địa chỉ nguồn như leaf thật (MAC), và địa chỉ được đăng ký với gateway
+        uint8_t addr[6];
+        uint32_t id;
+        if (cfg.transport == "udp") {
+            uint16_t leafPort = cfg.port + 1 + i;
+            l.link.reset(new UdpTransport(leafPort, "127.0.0.1", cfg.port));
+            UdpTransport::linkAddress("127.0.0.1", leafPort, addr);
+            id = nodeIdFromAddress(addr);
+        } else {
+            id = 0x00A10000u + i;
+            l.link.reset(new LoopbackTransport(bus, id));
+            LoopbackTransport::linkAddress(id, addr);
+        }
+        if (!gateway->allowLeaf(addr)) printf("leaf %d not registered: more than %d leaves\n", i, GATEWAY_MAX_NODES);
+        l.lossy.reset(new LossyTransport(*l.link, cfg.loss, 0x9E3779B9u ^ (i * 2654435761u)));
+        if (!l.lossy->begin()) {
+            printf("leaf %d transport init failed\n", i);
+            return 1;
+        }
+        l.id = id;
+        l.rng = 0x85EBCA6Bu ^ (uint32_t)(i * 2246822519u);
+        if (l.rng == 0) l.rng = 1;
+        bootLeaf(l);
+        l.nextRebootUs = cfg.rebootSec ? start + (uint64_t)cfg.rebootSec * 1000000 : UINT64_MAX;
+        l.nextSendUs = cfg.rate > 0 ? start + nextRand(l.rng) % (uint64_t)(1e6f / cfg.rate) : start;
+    }
+
+    // Frame giả: thiết bị lạ (địa chỉ chưa đăng ký) và leaf 1 (đã đăng ký) cùng gửi alarm mang ID
+    // của leaf 0. Gateway phải từ chối tất cả
+    std::unique_ptr<LinkTransport> rogue;
+    if (cfg.transport == "udp") rogue.reset(new UdpTransport(0, "127.0.0.1", cfg.port));
+    else rogue.reset(new LoopbackTransport(bus, 0x00BADBADu));
+    unsigned long spoofed = 0;
+    if (rogue->begin()) {
+        SensorData fake = {80.0f, 10.0f, 4000, true, true, PRIORITY_ALARM, monotonicUs()};
+        uint8_t frame[NODE_FRAME_SIZE];
+        for (uint16_t i = 0; i < SPOOF_FRAMES; i++) {
+            size_t n = encodeNodeFrame(fake, leaves[0].id, 1, 1000 + i, monotonicUs(), frame, sizeof(frame));
+            if (rogue->send(frame, n)) spoofed++;
+            if (cfg.nodes > 1 && leaves[1].link->send(frame, n)) spoofed++;
+        }
+    }
+
+    uplink.downFromUs = start + (uint64_t)cfg.durationSec * 250000;
+    uplink.downUntilUs = uplink.downFromUs + (uint64_t)cfg.outageSec * 1000000;
+
+    char rateText[32];
+    if (cfg.rate > 0) snprintf(rateText, sizeof(rateText), "%g Hz", cfg.rate);
+    else snprintf(rateText, sizeof(rateText), "flood");
+    printf("gateway_sim: %d nodes, %s, rate %s, %d s, alarm %.1f%%, loss %.1f%%, outage %d s\n", cfg.nodes,
+           cfg.transport.c_str(), rateText, cfg.durationSec, cfg.alarmRatio * 100, cfg.loss * 100,
+           cfg.outageSec);
+
+    unsigned long long sentRecords = 0, sentAlarms = 0, standaloneBytes = 0, leafReboots = 0;
+    uint64_t gatewayUs = 0;
+    uint64_t periodUs = cfg.rate > 0 ? (uint64_t)(1e6f / cfg.rate) : 0;
+    uint64_t deadline = start + (uint64_t)cfg.durationSec * 1000000;
+    char single[300];
+
+    while (monotonicUs() < deadline) {
+        uint64_t now = monotonicUs();
+        for (SimLeaf& l : leaves) {
+            if (now >= l.nextRebootUs) {
+                bootLeaf(l);
+                leafReboots++;
+                l.nextRebootUs += (uint64_t)cfg.rebootSec * 1000000;
+            }
+            if (now < l.nextSendUs) continue;
+            SensorData data = sampleLeaf(l, cfg);
+            l.node->send(data);
+            sentRecords++;
+            if (data.priority == PRIORITY_ALARM) sentAlarms++;
+            // Cùng bản ghi nếu node tự gửi lên AWS (chế độ độc lập)
+            standaloneBytes += serializeSensorData(data, "ESP32_01", single, sizeof(single));
+            l.nextSendUs = periodUs ? l.nextSendUs + periodUs : now;
+        }
+
+        // Flood: xả hết frame đang chờ trước vòng gửi tiếp theo để bus/socket không tràn
+        // Chỉ tính thời gian của các lượt có frame, bỏ các lượt poll rỗng
+        unsigned long before, after;
+        do {
+            before = handledFrames(gateway->stats());
+            uint64_t t0 = monotonicUs();
+            gateway->loop();
+            uint64_t t1 = monotonicUs();
+            after = handledFrames(gateway->stats());
+            if (after != before) gatewayUs += t1 - t0;
+        } while (after != before);
+
+        if (periodUs) delayMicroseconds(200);
+    }
+
+    // Chờ frame UDP cuối cùng rồi xả lô còn lại
+    delay(50);
+    for (int i = 0; i < 64; i++) gateway->loop();
+    while (gateway->pending() > 0 && gateway->flush()) {
+    }
+    double elapsed = (monotonicUs() - start) / 1e6;
+
+    const GatewayStats& s = gateway->stats();
+    unsigned long injectedLoss = 0;
+    for (SimLeaf& l : leaves) injectedLoss += l.lossy->lost;
+    unsigned long long framesOnAir = sentRecords + sentAlarms * (LEAF_ALARM_REPEATS - 1);
+    unsigned long handled = handledFrames(s);
+
+    printf("\nGateway\n");
+    printf("  leaf records sent      %llu (%llu alarms, %llu frames incl. repeats)\n",
+           sentRecords, sentAlarms, framesOnAir);
+    printf("  frames handled         %lu (%.0f frames/s)\n", handled, handled / elapsed);
+    printf("  accepted / dup / bad   %lu / %lu / %lu\n", s.frames, s.duplicates, s.invalid);
+    printf("  rejected (spoofed)     %lu (%lu forged frames sent)\n", s.rejected, spoofed);
+    printf("  seq gaps (lost)        %lu (injected %lu frames, bus overflow %lu)\n", s.lost, injectedLoss,
+           bus.overflows);
+    printf("  leaf reboots           %lu seen / %llu simulated\n", s.reboots, leafReboots);
+    printf("  unknown nodes          %lu\n", s.unknownNodes);
+    printf("  gateway CPU            %.0f ns/frame\n", handled ? gatewayUs * 1000.0 / handled : 0.0);
+
+    printf("\nUplink\n");
+    printf("  batches / records      %lu / %lu (%.2f records/batch)\n", s.batches, s.records,
+           s.batches ? (double)s.records / s.batches : 0.0);
+    printf("  bytes/record           %.1f B batched vs %.1f B standalone\n",
+           s.records ? (double)s.uplinkBytes / s.records : 0.0,
+           sentRecords ? (double)standaloneBytes / sentRecords : 0.0);
+    printf("  MQTT publishes         %lu vs %llu standalone\n", s.batches, sentRecords);
+    printf("  largest payload        %zu B (buffer %d B)\n", uplink.maxPayload, GATEWAY_PAYLOAD_SIZE);
+    printf("  failures / dropped     %lu / %lu (uplink down: %lu refused)\n", s.uplinkFailures, s.dropped,
+           uplink.refused);
+    printf("  alarms in / sent       %lu / %lu (%lu dropped)\n", s.alarms, s.alarmsSent, s.droppedAlarms);
+    printf("  oversized records      %lu (larger than the payload buffer on their own)\n", s.oversized);
+    printf("  capture->uplink        avg=%.3f ms  max=%.3f ms\n",
+           s.records ? s.latencySumUs / 1000.0 / s.records : 0.0, s.latencyMaxUs / 1000.0);
+
+    printf("\nMemory\n");
+    printf("  sizeof(Gateway)        %zu B (%d node slots)\n", sizeof(Gateway), GATEWAY_MAX_NODES);
+    printf("  gateway + 1 TLS        %.1f KB vs %d x %d KB TLS standalone = %.1f KB\n",
+           (sizeof(Gateway) + STANDALONE_TLS_BYTES) / 1024.0, cfg.nodes, STANDALONE_TLS_BYTES / 1024,
+           cfg.nodes * STANDALONE_TLS_BYTES / 1024.0);
+
+    // Kiểm tra: mọi alarm gateway nhận được đều phải lên cloud, kể cả khi uplink mất một lúc
+    bool alarmsOk = s.alarmsSent == s.alarms && gateway->pending() == 0;
+    printf("\nAlarm check              %s\n", alarmsOk ? "OK (no alarm lost)" : "FAILED");
+    // Frame giả ID từ địa chỉ lạ hoặc từ leaf khác không được lọt vào lô
+    bool spoofOk = s.rejected == spoofed;
+    printf("Spoof check              %s\n", spoofOk ? "OK (all forged frames rejected)" : "FAILED");
+    if (!spoofOk) return 2;
+    // Không mất gói thì mọi frame nhận được (trừ bản lặp của alarm) phải được chấp nhận, kể cả sau reboot
+    if (cfg.loss == 0 && bus.overflows == 0) {
+        bool dedupeOk = s.duplicates == sentAlarms * (LEAF_ALARM_REPEATS - 1) && s.frames == sentRecords;
+        printf("Dedupe check             %s\n", dedupeOk ? "OK" : "FAILED");
+        if (!dedupeOk) return 2;
+    }
+    return alarmsOk ? 0 : 2;
+}
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Giải mã trả lời truy vấn lịch sử (lệnh {"cmd":"history"}, xem src/history.h) ra CSV.
+
+Đầu vào: các message JSON từ topic esp32/history, mỗi dòng một message
+(ví dụ lưu từ AWS IoT MQTT test client hoặc mosquitto_sub).
+
+  mosquitto_sub ... -t esp32/history | python3 tools/history_decode/history_decode.py
+  python3 tools/history_decode/history_decode.py messages.jsonl --from 1760000000 > day.csv
+
+Định dạng block Gorilla (src/history/Gorilla.cpp), bit cao trước:
+  điểm đầu: ts:32 | 3 x giá trị:32 (float đã nhân scale)
+  điểm 2:   delta:14
+  sau đó:   dod '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+32 (bù 2)
+  giá trị:  '0' trùng | '10' + bit có nghĩa (cửa sổ cũ) | '11' + leading:5 + (len-1):5 + bit có nghĩa
+"""
+import argparse
+import base64
+import json
+import struct
+import sys
+
+CHANNELS = 3
+NAMES = ("temperature", "humidity", "gas")
+
+
+class BitReader:
+    def __init__(self, data, nbits):
+        self.data, self.nbits, self.pos = data, nbits, 0
+
+    def get(self, n):
+        v = 0
+        for _ in range(n):
+            bit = (self.data[self.pos >> 3] >> (7 - (self.pos & 7))) & 1 if self.pos < self.nbits else 0
+            v = (v << 1) | bit
+            self.pos += 1
+        return v
+
+
+def signed(v, n):
+    sign = 1 << (n - 1)
+    return (v ^ sign) - sign
+
+
+def decode_block(data, nbits, count, scale):
+    r = BitReader(data, nbits)
+    prev = [0] * CHANNELS
+    leading = [0] * CHANNELS
+    trailing = [0] * CHANNELS
+    ts = delta = 0
+
+    def value(ch):
+        if r.get(1) == 0:
+            return
+        if r.get(1) == 0:
+            length = 32 - leading[ch] - trailing[ch]
+            prev[ch] ^= r.get(length) << trailing[ch]
+            return
+        leading[ch] = r.get(5)
+        length = r.get(5) + 1
+        trailing[ch] = 32 - leading[ch] - length
+        prev[ch] ^= r.get(length) << trailing[ch]
+
+    for i in range(count):
+        if i == 0:
+            ts = r.get(32)
+            prev = [r.get(32) for _ in range(CHANNELS)]
+        else:
+            if i == 1:
+                delta = r.get(14)
+            elif r.get(1) == 0:
+                pass
+            elif r.get(1) == 0:
+                delta += signed(r.get(7), 7)
+            elif r.get(1) == 0:
+                delta += signed(r.get(9), 9)
+            elif r.get(1) == 0:
+                delta += signed(r.get(12), 12)
+            else:
+                delta += signed(r.get(32), 32)
+            ts += delta
+            for ch in range(CHANNELS):
+                value(ch)
+        vals = [struct.unpack("<f", struct.pack("<I", prev[ch]))[0] / scale[ch] for ch in range(CHANNELS)]
+        yield ts, vals
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("file", nargs="?", help="file JSON lines (mặc định stdin)")
+    ap.add_argument("--from", dest="ts_from", type=int, default=0)
+    ap.add_argument("--to", dest="ts_to", type=int, default=2**32 - 1)
+    args = ap.parse_args()
+
+    src = open(args.file) if args.file else sys.stdin
+    points = {}
+    summary = None
+    for line in src:
+        line = line.strip()
+        if not line:
+            continue
+        msg = json.loads(line)
+        if msg.get("type") == "history_end":
+            summary = msg
+            continue
+        if msg.get("type") != "history":
+            continue
+        data = base64.b64decode(msg["data"])
+        for ts, vals in decode_block(data, msg["bits"], msg["count"], msg["scale"]):
+            if args.ts_from <= ts <= args.ts_to:
+                points[ts] = vals  # block có thể gửi lặp, trùng ts thì giữ bản sau
+
+    print("timestamp," + ",".join(NAMES))
+    for ts in sorted(points):
+        t, h, g = points[ts]
+        print("%d,%.1f,%.1f,%d" % (ts, t, h, round(g)))
+
+    if summary:
+        print("# %d points, %d B (%.2f B/point), encode %d us, total %d us"
+              % (summary["points"], summary["bytes"], summary["bytesPerPoint"],
+                 summary["encodeUs"], summary["totalUs"]), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+// Arduino.h (host) — tập con Arduino core đủ để biên dịch code firmware trên PC.
+// Chỉ dùng cho các env native trong platformio.ini, không dùng trên ESP32.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define F(s) (s)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostSkipDelays(bool skip);        // delay()/delayMicroseconds() trả về ngay, dùng khi benchmark
+void hostAdvanceTime(unsigned long ms); // đẩy millis()/micros() tới trước (bỏ qua warm-up)
+
+// GPIO giả lập: ghi lại trạng thái chân, analogRead trả về giá trị đặt bằng hostSetAnalog()
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void hostSetDigital(uint8_t pin, int val);
+void hostSetAnalog(uint8_t pin, uint16_t val);
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+class String {
+  public:
+    String() {}
+    String(const char* s) : str(s ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    String(int v) : str(std::to_string(v)) {}
+    String(unsigned long v) : str(std::to_string(v)) {}
+
+    String& operator+=(char c) { str += c; return *this; }
+    String& operator+=(const char* s) { str += s; return *this; }
+    String& operator+=(const String& s) { str += s.str; return *this; }
+    bool operator==(const char* s) const { return str == s; }
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.size(); }
+
+  private:
+    std::string str;
+};
+
+class HardwareSerial {
+  public:
+    void begin(unsigned long baud) { (void)baud; }
+    void setQuiet(bool q) { quiet = q; }  // tắt output khi chạy benchmark/tải lớn
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t len);
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c);
+    size_t print(int v);
+    size_t print(unsigned int v);
+    size_t print(long v);
+    size_t print(unsigned long v);
+    size_t print(double v, int digits = 2);
+    size_t println();
+    template <typename T> size_t println(const T& v) { return print(v) + println(); }
+    size_t println(double v, int digits) { return print(v, digits) + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  private:
+    bool quiet = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif
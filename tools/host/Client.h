@@ -0,0 +1,19 @@
+// Client.h (host) — interface giống Arduino Client để PubSubClient dùng chung
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include <Arduino.h>
+
+class Client {
+  public:
+    virtual ~Client() {}
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t* buf, size_t size) = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+
+HardwareSerial Serial;
+WiFiClass WiFi;
+TwoWire Wire;
+
+static const auto hostStart = std::chrono::steady_clock::now();
+static unsigned long long hostOffsetUs = 0;
+
+unsigned long millis() {
+    return (unsigned long)((std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hostStart).count() + hostOffsetUs) / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hostStart).count() + hostOffsetUs);
+}
+
+static bool skipDelays = false;
+
+void delay(unsigned long ms) {
+    if (!skipDelays) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+void delayMicroseconds(unsigned int us) {
+    if (!skipDelays) std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+void hostSkipDelays(bool skip) { skipDelays = skip; }
+void hostAdvanceTime(unsigned long ms) { hostOffsetUs += (unsigned long long)ms * 1000; }
+
+// ------------------ GPIO GIẢ LẬP ------------------
+static int pinState[64];
+static uint16_t analogState[64];
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < 64) pinState[pin] = val; }
+int digitalRead(uint8_t pin) { return pin < 64 ? pinState[pin] : LOW; }
+uint16_t analogRead(uint8_t pin) { return pin < 64 ? analogState[pin] : 0; }
+void hostSetDigital(uint8_t pin, int val) { if (pin < 64) pinState[pin] = val; }
+void hostSetAnalog(uint8_t pin, uint16_t val) { if (pin < 64) analogState[pin] = val; }
+
+// Trên host đồng hồ hệ thống đã đồng bộ sẵn
+void configTime(long, int, const char*, const char*, const char*) {}
+
+// ------------------ SERIAL → STDOUT ------------------
+size_t HardwareSerial::write(uint8_t c) { return quiet ? 1 : fwrite(&c, 1, 1, stdout); }
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) { return quiet ? len : fwrite(buf, 1, len, stdout); }
+size_t HardwareSerial::print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+size_t HardwareSerial::print(char c) { return write((uint8_t)c); }
+size_t HardwareSerial::print(int v) { return printf("%d", v); }
+size_t HardwareSerial::print(unsigned int v) { return printf("%u", v); }
+size_t HardwareSerial::print(long v) { return printf("%ld", v); }
+size_t HardwareSerial::print(unsigned long v) { return printf("%lu", v); }
+size_t HardwareSerial::print(double v, int digits) { return printf("%.*f", digits, v); }
+size_t HardwareSerial::println() { return print("\r\n"); }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    if (quiet) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n > 0 ? (size_t)n : 0;
+}
@@ -0,0 +1,42 @@
+// Print.h (host) — lớp Print tối thiểu của Arduino core (U8g2 kế thừa lớp này)
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <Arduino.h>
+#include <stdio.h>
+
+class Print {
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (len--) n += write(*buf++);
+        return n;
+    }
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T& v) { return print(v) + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[128];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n <= 0) return 0;
+        return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+    }
+};
+
+#endif
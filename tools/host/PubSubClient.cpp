@@ -0,0 +1,236 @@
+#include "PubSubClient.h"
+
+#define MQTT_MAX_HEADER_SIZE 5
+
+#define MQTTCONNECT     (1 << 4)
+#define MQTTCONNACK     (2 << 4)
+#define MQTTPUBLISH     (3 << 4)
+#define MQTTPUBACK      (4 << 4)
+#define MQTTSUBSCRIBE   (8 << 4)
+#define MQTTSUBACK      (9 << 4)
+#define MQTTPINGREQ     (12 << 4)
+#define MQTTPINGRESP    (13 << 4)
+#define MQTTDISCONNECT  (14 << 4)
+#define MQTTQOS1        (1 << 1)
+
+PubSubClient::PubSubClient()
+    : _client(nullptr), buffer(MQTT_MAX_PACKET_SIZE), domain(nullptr), port(0),
+      keepAlive(MQTT_KEEPALIVE), nextMsgId(1), lastOutActivity(0), lastInActivity(0),
+      pingOutstanding(false), _state(MQTT_DISCONNECTED), callback(nullptr) {}
+
+PubSubClient::PubSubClient(Client& client) : PubSubClient() { _client = &client; }
+
+PubSubClient& PubSubClient::setServer(const char* d, uint16_t p) {
+    domain = d;
+    port = p;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE) {
+    this->callback = callback;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setClient(Client& client) {
+    _client = &client;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setKeepAlive(uint16_t k) {
+    keepAlive = k;
+    return *this;
+}
+
+bool PubSubClient::setBufferSize(uint16_t size) {
+    if (size == 0) return false;
+    buffer.assign(size, 0);
+    return true;
+}
+
+// Ghi chuỗi UTF-8 có tiền tố độ dài 2 byte vào buffer
+size_t PubSubClient::writeString(const char* s, size_t pos) {
+    size_t len = strlen(s);
+    if (pos + 2 + len > buffer.size()) return 0;
+    buffer[pos++] = (uint8_t)(len >> 8);
+    buffer[pos++] = (uint8_t)(len & 0xFF);
+    memcpy(&buffer[pos], s, len);
+    return pos + len;
+}
+
+// Body đã nằm ở buffer[MQTT_MAX_HEADER_SIZE..]; chèn fixed header ngay phía trước rồi gửi một lần
+bool PubSubClient::writePacket(uint8_t header, size_t length) {
+    uint8_t lenBuf[4];
+    uint8_t llen = 0;
+    size_t len = length;
+    do {
+        uint8_t digit = len % 128;
+        len /= 128;
+        if (len > 0) digit |= 0x80;
+        lenBuf[llen++] = digit;
+    } while (len > 0 && llen < 4);
+
+    size_t start = MQTT_MAX_HEADER_SIZE - 1 - llen;
+    buffer[start] = header;
+    memcpy(&buffer[start + 1], lenBuf, llen);
+
+    size_t total = 1 + llen + length;
+    size_t rc = _client->write(&buffer[start], total);
+    lastOutActivity = millis();
+    return rc == total;
+}
+
+// Đọc một gói vào buffer[0..], trả về header và độ dài phần thân
+bool PubSubClient::readPacket(uint8_t& header, size_t& length, unsigned long timeoutMs) {
+    unsigned long start = millis();
+    auto readByte = [&](uint8_t& b) {
+        while (!_client->available()) {
+            if (!_client->connected() || millis() - start >= timeoutMs) return false;
+            delayMicroseconds(50);
+        }
+        int c = _client->read();
+        if (c < 0) return false;
+        b = (uint8_t)c;
+        return true;
+    };
+
+    if (!readByte(header)) return false;
+
+    length = 0;
+    size_t mult = 1;
+    uint8_t digit;
+    do {
+        if (!readByte(digit)) return false;
+        length += (digit & 0x7F) * mult;
+        mult *= 128;
+    } while (digit & 0x80);
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t b;
+        if (!readByte(b)) return false;
+        if (i < buffer.size()) buffer[i] = b; // gói lớn hơn buffer bị cắt, giống thư viện gốc
+    }
+    lastInActivity = millis();
+    return true;
+}
+
+bool PubSubClient::connect(const char* id) {
+    if (connected()) return true;
+    if (!_client || !domain || !_client->connect(domain, port)) {
+        _state = MQTT_CONNECT_FAILED;
+        return false;
+    }
+
+    static const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0x02}; // clean session
+    size_t pos = MQTT_MAX_HEADER_SIZE;
+    memcpy(&buffer[pos], protocol, sizeof(protocol));
+    pos += sizeof(protocol);
+    buffer[pos++] = (uint8_t)(keepAlive >> 8);
+    buffer[pos++] = (uint8_t)(keepAlive & 0xFF);
+    pos = writeString(id, pos);
+    if (pos == 0 || !writePacket(MQTTCONNECT, pos - MQTT_MAX_HEADER_SIZE)) {
+        _client->stop();
+        _state = MQTT_CONNECT_FAILED;
+        return false;
+    }
+
+    uint8_t header;
+    size_t length;
+    if (!readPacket(header, length, MQTT_SOCKET_TIMEOUT * 1000UL)) {
+        _client->stop();
+        _state = MQTT_CONNECTION_TIMEOUT;
+        return false;
+    }
+    if ((header & 0xF0) != MQTTCONNACK || length < 2 || buffer[1] != 0) {
+        _client->stop();
+        _state = length >= 2 ? buffer[1] : MQTT_CONNECT_FAILED;
+        return false;
+    }
+
+    pingOutstanding = false;
+    _state = MQTT_CONNECTED;
+    return true;
+}
+
+void PubSubClient::disconnect() {
+    if (_client && _client->connected()) {
+        buffer[MQTT_MAX_HEADER_SIZE] = 0;
+        writePacket(MQTTDISCONNECT, 0);
+        _client->stop();
+    }
+    _state = MQTT_DISCONNECTED;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload) {
+    return publish(topic, (const uint8_t*)payload, payload ? (unsigned int)strlen(payload) : 0, false);
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+    return publish(topic, (const uint8_t*)payload, payload ? (unsigned int)strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, bool retained) {
+    if (!connected()) return false;
+    if (MQTT_MAX_HEADER_SIZE + 2 + strlen(topic) + plength > buffer.size()) return false; // quá buffer
+
+    size_t pos = writeString(topic, MQTT_MAX_HEADER_SIZE);
+    memcpy(&buffer[pos], payload, plength);
+    pos += plength;
+    return writePacket(MQTTPUBLISH | (retained ? 1 : 0), pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos) {
+    if (!connected()) return false;
+    size_t pos = MQTT_MAX_HEADER_SIZE;
+    uint16_t msgId = nextMsgId++;
+    if (nextMsgId == 0) nextMsgId = 1;
+    buffer[pos++] = (uint8_t)(msgId >> 8);
+    buffer[pos++] = (uint8_t)(msgId & 0xFF);
+    pos = writeString(topic, pos);
+    if (pos == 0 || pos >= buffer.size()) return false;
+    buffer[pos++] = qos;
+    return writePacket(MQTTSUBSCRIBE | MQTTQOS1, pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::loop() {
+    if (!connected()) return false;
+
+    unsigned long now = millis();
+    if (keepAlive && now - lastOutActivity > keepAlive * 1000UL) {
+        if (pingOutstanding && now - lastInActivity > keepAlive * 1500UL) {
+            _state = MQTT_CONNECTION_TIMEOUT;
+            _client->stop();
+            return false;
+        }
+        writePacket(MQTTPINGREQ, 0);
+        pingOutstanding = true;
+    }
+
+    while (_client->available()) {
+        uint8_t header;
+        size_t length;
+        if (!readPacket(header, length, MQTT_SOCKET_TIMEOUT * 1000UL)) break;
+
+        uint8_t type = header & 0xF0;
+        if (type == MQTTPINGRESP) {
+            pingOutstanding = false;
+        } else if (type == MQTTPUBLISH && callback && length >= 2 && length < buffer.size()) {
+            size_t topicLen = (buffer[0] << 8) | buffer[1];
+            if (2 + topicLen > length) continue;
+            size_t payloadPos = 2 + topicLen + ((header & 0x06) ? 2 : 0);
+            // Giống thư viện gốc: dịch topic lùi 1 byte để chèn '\0'
+            memmove(&buffer[0], &buffer[2], topicLen);
+            buffer[topicLen] = 0;
+            callback((char*)&buffer[0], &buffer[payloadPos], (unsigned int)(length - payloadPos));
+        }
+    }
+    return true;
+}
+
+bool PubSubClient::connected() {
+    if (!_client) return false;
+    if (!_client->connected()) {
+        if (_state == MQTT_CONNECTED) _state = MQTT_CONNECTION_LOST;
+        return false;
+    }
+    return _state == MQTT_CONNECTED;
+}
@@ -0,0 +1,63 @@
+// PubSubClient.h (host) — bản rút gọn API knolleary/PubSubClient trên Client host.
+// MQTT 3.1.1: CONNECT, PUBLISH QoS0, SUBSCRIBE, PINGREQ và nhận PUBLISH QoS0.
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "Client.h"
+
+#define MQTT_MAX_PACKET_SIZE 256
+#define MQTT_KEEPALIVE 15
+#define MQTT_SOCKET_TIMEOUT 15
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+class PubSubClient {
+  public:
+    PubSubClient();
+    PubSubClient(Client& client);
+
+    PubSubClient& setServer(const char* domain, uint16_t port);
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+    PubSubClient& setClient(Client& client);
+    PubSubClient& setKeepAlive(uint16_t keepAlive);
+    bool setBufferSize(uint16_t size);
+    uint16_t getBufferSize() const { return (uint16_t)buffer.size(); }
+
+    bool connect(const char* id);
+    void disconnect();
+    bool publish(const char* topic, const char* payload);
+    bool publish(const char* topic, const char* payload, bool retained);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int plength, bool retained = false);
+    bool subscribe(const char* topic, uint8_t qos = 0);
+    bool loop();
+    bool connected();
+    int state() const { return _state; }
+
+  private:
+    bool writePacket(uint8_t header, size_t length);
+    bool readPacket(uint8_t& header, size_t& length, unsigned long timeoutMs);
+    size_t writeString(const char* s, size_t pos);
+
+    Client* _client;
+    std::vector<uint8_t> buffer;
+    const char* domain;
+    uint16_t port;
+    uint16_t keepAlive;
+    uint16_t nextMsgId;
+    unsigned long lastOutActivity;
+    unsigned long lastInActivity;
+    bool pingOutstanding;
+    int _state;
+    MQTT_CALLBACK_SIGNATURE;
+};
+
+#endif
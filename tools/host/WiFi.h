@@ -0,0 +1,23 @@
+// WiFi.h (host) — mạng của PC luôn "đã kết nối"
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_DISCONNECTED = 6,
+    WL_CONNECTED = 3
+} wl_status_t;
+
+class WiFiClass {
+  public:
+    wl_status_t begin(const char*, const char* = nullptr) { return WL_CONNECTED; }
+    wl_status_t status() { return WL_CONNECTED; }
+    void disconnect(bool = false) {}
+};
+
+extern WiFiClass WiFi;
+
+#endif
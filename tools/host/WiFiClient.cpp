@@ -0,0 +1,172 @@
+#include "WiFiClient.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClient::WiFiClient() : fd(-1), loopback(false), rxLoopPos(0), bytesSent(0) {}
+
+WiFiClient::~WiFiClient() { stop(); }
+
+// Connect non-blocking rồi chờ bằng poll(), giống lwip_connect + select trong WiFiClient của ESP32
+static bool connectWithTimeout(int fd, const sockaddr* addr, socklen_t len, int32_t timeoutMs) {
+    if (timeoutMs < 0) return ::connect(fd, addr, len) == 0;
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int rc = ::connect(fd, addr, len);
+    if (rc != 0 && errno == EINPROGRESS) {
+        pollfd p = {fd, POLLOUT, 0};
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        if (poll(&p, 1, timeoutMs) == 1 && getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) == 0 && err == 0)
+            rc = 0;
+    }
+    fcntl(fd, F_SETFL, flags);
+    return rc == 0;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) { return connect(host, port, -1); }
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    stop();
+    if (strcmp(host, "loopback") == 0) {
+        loopback = true;
+        return 1;
+    }
+
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res) return 0;
+
+    fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && !connectWithTimeout(fd, res->ai_addr, res->ai_addrlen, timeoutMs)) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) return 0;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // giống lwIP: gửi ngay gói nhỏ
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    if (loopback) {
+        loopbackReply(buf, size);
+        bytesSent += size;
+        return size;
+    }
+    if (fd < 0) return 0;
+
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            stop();
+            return sent;
+        }
+        sent += (size_t)n;
+    }
+    bytesSent += sent;
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (loopback) return (int)(rxLoop.size() - rxLoopPos);
+    if (fd < 0) return 0;
+    int n = 0;
+    if (ioctl(fd, FIONREAD, &n) != 0) return 0;
+    return n;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (loopback) {
+        size_t n = rxLoop.size() - rxLoopPos;
+        if (n > size) n = size;
+        memcpy(buf, rxLoop.data() + rxLoopPos, n);
+        rxLoopPos += n;
+        if (rxLoopPos == rxLoop.size()) {
+            rxLoop.clear();
+            rxLoopPos = 0;
+        }
+        return (int)n;
+    }
+    if (fd < 0) return -1;
+    ssize_t n = recv(fd, buf, size, 0);
+    if (n <= 0) {
+        stop();
+        return -1;
+    }
+    return (int)n;
+}
+
+void WiFiClient::stop() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    loopback = false;
+    rxLoop.clear();
+    rxLoopPos = 0;
+}
+
+// Giống ESP32: peek 1 byte để phát hiện phía bên kia đã đóng kết nối
+uint8_t WiFiClient::connected() {
+    if (loopback) return 1;
+    if (fd < 0) return 0;
+    uint8_t c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+// Broker giả: mỗi lần write() là một gói MQTT hoàn chỉnh (PubSubClient host ghi cả gói một lần)
+void WiFiClient::loopbackReply(const uint8_t* buf, size_t size) {
+    if (size < 2) return;
+    uint8_t type = buf[0] >> 4;
+
+    // Bỏ qua trường "remaining length" (1–4 byte) để tới variable header
+    size_t pos = 1;
+    while (pos < size && (buf[pos++] & 0x80)) {}
+
+    switch (type) {
+    case 1: // CONNECT → CONNACK accepted
+        rxLoop.insert(rxLoop.end(), {0x20, 0x02, 0x00, 0x00});
+        break;
+    case 3: // PUBLISH QoS1 → PUBACK
+        if ((buf[0] & 0x06) == 0x02 && pos + 2 <= size) {
+            size_t topicLen = (buf[pos] << 8) | buf[pos + 1];
+            size_t idPos = pos + 2 + topicLen;
+            if (idPos + 2 <= size)
+                rxLoop.insert(rxLoop.end(), {0x40, 0x02, buf[idPos], buf[idPos + 1]});
+        }
+        break;
+    case 8: // SUBSCRIBE → SUBACK QoS0
+        if (pos + 2 <= size)
+            rxLoop.insert(rxLoop.end(), {0x90, 0x03, buf[pos], buf[pos + 1], 0x00});
+        break;
+    case 12: // PINGREQ → PINGRESP
+        rxLoop.insert(rxLoop.end(), {0xD0, 0x00});
+        break;
+    default:
+        break;
+    }
+}
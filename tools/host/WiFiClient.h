@@ -0,0 +1,36 @@
+// WiFiClient.h (host) — TCP client bằng POSIX socket.
+// Host "loopback" không mở socket: một broker MQTT giả trong process trả CONNACK/SUBACK/
+// PUBACK/PINGRESP, dùng để đo riêng chi phí phía thiết bị khi không có Mosquitto.
+#ifndef HOST_WIFICLIENT_H
+#define HOST_WIFICLIENT_H
+
+#include "Client.h"
+#include <vector>
+
+class WiFiClient : public Client {
+  public:
+    WiFiClient();
+    ~WiFiClient() override;
+
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeoutMs); // như WiFiClient của ESP32, -1 = chờ mãi
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    void stop() override;
+    uint8_t connected() override;
+
+    unsigned long getBytesSent() const { return bytesSent; }
+
+  private:
+    void loopbackReply(const uint8_t* buf, size_t size);
+
+    int fd;
+    bool loopback;
+    std::vector<uint8_t> rxLoop; // dữ liệu broker giả gửi về
+    size_t rxLoopPos;
+    unsigned long bytesSent;
+};
+
+#endif
@@ -0,0 +1,15 @@
+// WiFiClientSecure.h (host) — không có TLS trên host, chứng chỉ bị bỏ qua
+#ifndef HOST_WIFICLIENTSECURE_H
+#define HOST_WIFICLIENTSECURE_H
+
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+  public:
+    void setCACert(const char*) {}
+    void setCertificate(const char*) {}
+    void setPrivateKey(const char*) {}
+    void setInsecure() {}
+};
+
+#endif
@@ -0,0 +1,22 @@
+// Wire.h (host) — bus I2C giả: nhận dữ liệu rồi bỏ, đủ để U8g2 chạy sendBuffer() trên PC
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+  public:
+    bool begin() { return true; }
+    bool begin(int sda, int scl) { (void)sda; (void)scl; return true; }
+    void setClock(uint32_t hz) { (void)hz; }
+    void beginTransmission(uint8_t addr) { (void)addr; }
+    size_t write(uint8_t c) { (void)c; bytesWritten++; return 1; }
+    size_t write(const uint8_t* buf, size_t len) { (void)buf; bytesWritten += len; return len; }
+    uint8_t endTransmission(bool stop = true) { (void)stop; return 0; }
+
+    unsigned long bytesWritten = 0; // tổng byte "gửi" lên màn hình
+};
+
+extern TwoWire Wire;
+
+#endif
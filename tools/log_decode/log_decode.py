@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Giải mã log nhị phân của firmware (build với -DLOG_BINARY=1, xem src/logging/Logger.h).
+
+Chuỗi format không được gửi qua UART, chỉ có địa chỉ của nó trong flash; script đọc
+chuỗi tương ứng từ file ELF của đúng bản build đang chạy.
+
+  python3 tools/log_decode/log_decode.py --elf .pio/build/esp32dev/firmware.elf --port /dev/ttyUSB0
+  python3 tools/log_decode/log_decode.py --elf firmware.elf --file capture.bin
+
+Khung: 0xA5 | length:u16 | level:u8 | argc:u8 | timeMs:u32 | fmt:u32 | tham số...
+Tham số: type:u8 rồi giá trị (i32/u32: 4 byte, i64/u64/double: 8 byte, string: len:u8 + byte, ptr: 4 byte).
+"""
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER = struct.Struct("<HBBII")
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+LEVEL_DROPPED = 0xFF
+ARG_I32, ARG_U32, ARG_I64, ARG_U64, ARG_DOUBLE, ARG_STRING, ARG_PTR = range(7)
+SPEC = re.compile(r"%([-+ #0]*(?:\d+|\*)?(?:\.(?:\d+|\*))?)(hh|h|ll|l|z|j|t)?([diouxXeEfFgGcsp%])")
+
+
+class Elf32:
+    """Đọc chuỗi C tại địa chỉ ảo từ các section có dữ liệu của file ELF32 little-endian."""
+
+    def __init__(self, path):
+        self.data = open(path, "rb").read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1:
+            raise ValueError("not an ELF32 file: %s" % path)
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, _, addr, offset, size = struct.unpack_from("<IIIIII", self.data, shoff + i * shentsize)
+            if sh_type == 1 and addr:  # SHT_PROGBITS
+                self.sections.append((addr, offset, size))
+        self.cache = {}
+
+    def string(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.index(b"\0", start)
+                s = self.data[start:end].decode("utf-8", "replace")
+                self.cache[addr] = s
+                return s
+        return "<fmt@0x%08x>" % addr
+
+
+def parse_args(buf, argc):
+    args, pos = [], 0
+    for _ in range(argc):
+        t = buf[pos]
+        pos += 1
+        if t in (ARG_I32, ARG_U32, ARG_PTR):
+            args.append(struct.unpack_from("<i" if t == ARG_I32 else "<I", buf, pos)[0])
+            pos += 4
+        elif t in (ARG_I64, ARG_U64, ARG_DOUBLE):
+            fmt = {ARG_I64: "<q", ARG_U64: "<Q", ARG_DOUBLE: "<d"}[t]
+            args.append(struct.unpack_from(fmt, buf, pos)[0])
+            pos += 8
+        elif t == ARG_STRING:
+            n = buf[pos]
+            args.append(buf[pos + 1:pos + 1 + n].decode("utf-8", "replace"))
+            pos += 1 + n
+        else:
+            break
+    return args
+
+
+def render(fmt, args):
+    it = iter(args)
+
+    def repl(m):
+        flags, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        try:
+            while "*" in flags:  # width/precision lấy từ tham số int, như printf
+                flags = flags.replace("*", str(int(next(it))), 1)
+            v = next(it)
+        except StopIteration:
+            return "?"
+        if conv in "iu":
+            conv = "d"
+        if conv == "p":
+            return "0x%08x" % v
+        try:
+            return ("%" + flags + conv) % v
+        except (TypeError, ValueError):
+            return str(v)
+
+    return SPEC.sub(repl, fmt)
+
+
+def decode(stream, elf, out):
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf.extend(chunk)
+        while True:
+            i = buf.find(bytes([SYNC]))
+            if i < 0:
+                buf.clear()
+                break
+            del buf[:i]
+            if len(buf) < 1 + HEADER.size:
+                break
+            length, level, argc, ms, fmt_addr = HEADER.unpack_from(buf, 1)
+            if length < HEADER.size or length > 256:
+                del buf[:1]  # mất đồng bộ, tìm byte sync tiếp theo
+                continue
+            if len(buf) < 1 + length:
+                break
+            body = bytes(buf[1 + HEADER.size:1 + length])
+            del buf[:1 + length]
+            args = parse_args(body, argc)
+            if level == LEVEL_DROPPED:
+                out.write("[%10.3f] [LOG] %d messages dropped (ring full)\n" % (ms / 1000.0, args[0] if args else 0))
+            else:
+                out.write("[%10.3f] %s %s\n" % (ms / 1000.0, LEVELS.get(level, "?"), render(elf.string(fmt_addr), args)))
+            out.flush()
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--elf", required=True)
+    p.add_argument("--port")
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--file")
+    a = p.parse_args()
+
+    elf = Elf32(a.elf)
+    if a.port:
+        import serial  # pyserial, có sẵn trong môi trường PlatformIO
+        stream = serial.Serial(a.port, a.baud)
+    elif a.file:
+        stream = open(a.file, "rb")
+    else:
+        stream = sys.stdin.buffer
+    decode(stream, elf, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Tạo bản vá delta (định dạng DLT1, xem src/ota/OTAUpdater.cpp) từ image cũ sang image mới.
+
+  python3 tools/ota_host/make_delta.py old.bin new.bin fw.delta
+
+So khớp theo block: mỗi block BLOCK byte của image mới được tìm trong image cũ
+(qua bảng băm), rồi kéo dài đoạn khớp càng xa càng tốt. Phần không khớp được chèn nguyên.
+In ra SHA-256 và kích thước của image mới để điền vào lệnh OTA.
+"""
+import hashlib
+import struct
+import sys
+
+BLOCK = 64
+
+
+def make_delta(old, new):
+    index = {}
+    for i in range(0, len(old) - BLOCK + 1, 4):
+        index.setdefault(old[i:i + BLOCK], i)
+
+    out = bytearray(b"DLT1")
+    pending = bytearray()
+
+    def flush_insert():
+        if pending:
+            out.extend(b"I" + struct.pack("<I", len(pending)))
+            out.extend(pending)
+            pending.clear()
+
+    pos = 0
+    while pos < len(new):
+        src = index.get(new[pos:pos + BLOCK]) if pos + BLOCK <= len(new) else None
+        if src is None:
+            pending.append(new[pos])
+            pos += 1
+            continue
+        length = BLOCK
+        while pos + length < len(new) and src + length < len(old) and new[pos + length] == old[src + length]:
+            length += 1
+        flush_insert()
+        out.extend(b"C" + struct.pack("<II", src, length))
+        pos += length
+    flush_insert()
+    return bytes(out)
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__)
+        sys.exit(1)
+    old = open(sys.argv[1], "rb").read()
+    new = open(sys.argv[2], "rb").read()
+    delta = make_delta(old, new)
+    open(sys.argv[3], "wb").write(delta)
+    print("image  %d bytes  sha256=%s" % (len(new), hashlib.sha256(new).hexdigest()))
+    print("delta  %d bytes  (%.1f%% of full image)" % (len(delta), 100.0 * len(delta) / max(1, len(new))))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+// ota_host — chạy OTAUpdater của firmware trên PC với server HTTP cục bộ (ota_server.py).
+//
+// Partition được giả lập bằng file: --base là image đang chạy (nguồn cho delta),
+// --out là slot chưa chạy. Trong lúc tải, một vòng lặp giống loop() của firmware chạy
+// song song (đóng gói JSON + đọc cảm biến giả) để đo ảnh hưởng của OTA lên độ trễ vòng lặp.
+//
+//   ota_host --url http://127.0.0.1:8000/fw.bin --expect fw.bin --out slot_b.bin
+//   ota_host --url http://127.0.0.1:8000/fw.delta --delta --base old.bin --expect fw.bin --out slot_b.bin
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "ota/OTAUpdater.h"
+#include "logging/Logger.h"
+#include "telemetry/SensorData.h"
+#include "telemetry/TimeBase.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// ------------------ PARTITION GIẢ BẰNG FILE ------------------
+class FileOTASink : public OTASink {
+  public:
+    FileOTASink(const char* outPath, const char* basePath)
+        : outPath(outPath), basePath(basePath), out(nullptr), base(nullptr), finished(false) {}
+
+    bool begin(size_t imageSize) override {
+        out = fopen((outPath + ".part").c_str(), "wb");
+        if (basePath) base = fopen(basePath, "rb");
+        expected = imageSize;
+        written = 0;
+        return out && (!basePath || base);
+    }
+
+    bool write(const uint8_t* data, size_t len) override {
+        written += len;
+        return fwrite(data, 1, len, out) == len;
+    }
+
+    bool readBase(size_t offset, uint8_t* data, size_t len) override {
+        return base && fseek(base, (long)offset, SEEK_SET) == 0 && fread(data, 1, len, base) == len;
+    }
+
+    // Giống Update.end(): chỉ "kích hoạt" slot mới khi đã ghi đủ
+    bool finish() override {
+        closeFiles();
+        if (written != expected) return false;
+        finished = rename((outPath + ".part").c_str(), outPath.c_str()) == 0;
+        return finished;
+    }
+
+    void abort() override {
+        closeFiles();
+        remove((outPath + ".part").c_str());
+    }
+
+  private:
+    void closeFiles() {
+        if (out) fclose(out);
+        if (base) fclose(base);
+        out = base = nullptr;
+    }
+
+    std::string outPath;
+    const char* basePath;
+    FILE* out;
+    FILE* base;
+    size_t expected;
+    size_t written;
+    bool finished;
+};
+
+// ------------------ TIỆN ÍCH ------------------
+static bool sha256OfFile(const char* path, size_t& size, char hex[65]) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    Sha256 sha;
+    uint8_t buf[4096];
+    size = 0;
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        sha.update(buf, n);
+        size += n;
+    }
+    fclose(f);
+    uint8_t digest[32];
+    sha.finish(digest);
+    for (int i = 0; i < 32; i++) snprintf(hex + i * 2, 3, "%02x", digest[i]);
+    return true;
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void printLoopStats(const char* name, const std::vector<uint32_t>& v) {
+    uint32_t mx = v.empty() ? 0 : *std::max_element(v.begin(), v.end());
+    printf("  %-14s p50=%6u us  p99=%6u us  max=%7u us  (n=%zu)\n", name,
+           percentile(v, 0.50), percentile(v, 0.99), mx, v.size());
+}
+
+// Công việc của một vòng loop() firmware (không tính I/O phần cứng)
+static void simulatedSensingWork(unsigned long iteration) {
+    SensorData data = {28.5f + (iteration % 7) * 0.1f, 65.0f, 300 + (int)(iteration % 50), false, false,
+                       PRIORITY_ROUTINE, monotonicUs()};
+    char payload[300];
+    serializeSensorData(data, "ESP32_01", payload, sizeof(payload));
+}
+
+static void usage() {
+    printf("usage: ota_host --url URL --out FILE (--expect IMAGE | --size N --sha256 HEX)\n"
+           "                [--delta --base OLD_IMAGE] [--baseline-ms MS]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* url = nullptr;
+    const char* outPath = nullptr;
+    const char* basePath = nullptr;
+    const char* expectPath = nullptr;
+    const char* shaArg = nullptr;
+    size_t size = 0;
+    bool delta = false;
+    unsigned long baselineMs = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--delta") { delta = true; continue; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        const char* v = argv[++i];
+        if (a == "--url") url = v;
+        else if (a == "--out") outPath = v;
+        else if (a == "--base") basePath = v;
+        else if (a == "--expect") expectPath = v;
+        else if (a == "--sha256") shaArg = v;
+        else if (a == "--size") size = strtoul(v, nullptr, 10);
+        else if (a == "--baseline-ms") baselineMs = strtoul(v, nullptr, 10);
+        else { usage(); return 1; }
+    }
+
+    char sha[65] = {0};
+    if (expectPath && !sha256OfFile(expectPath, size, sha)) {
+        printf("cannot read %s\n", expectPath);
+        return 1;
+    }
+    if (shaArg) snprintf(sha, sizeof(sha), "%s", shaArg);
+    if (!url || !outPath || size == 0 || strlen(sha) != 64 || (delta && !basePath)) {
+        usage();
+        return 1;
+    }
+
+    WiFiClient net;
+    FileOTASink sink(outPath, basePath);
+    OTAUpdater updater(net, sink);
+
+    std::vector<uint32_t> idleLoop, otaLoop;
+    unsigned long iteration = 0;
+
+    // Pha 1: vòng lặp không có OTA làm mốc so sánh
+    unsigned long phaseEnd = millis() + baselineMs;
+    while (millis() < phaseEnd) {
+        unsigned long t0 = micros();
+        simulatedSensingWork(iteration++);
+        idleLoop.push_back(micros() - t0);
+    }
+
+    // Pha 2: vòng lặp có OTA chạy xen kẽ
+    if (!updater.start(url, size, sha, delta)) return 1;
+    unsigned long otaStart = micros();
+    while (updater.isActive()) {
+        unsigned long t0 = micros();
+        simulatedSensingWork(iteration++);
+        updater.loop();
+        otaLoop.push_back(micros() - t0);
+        logPoll(); // trên ESP32 là task log riêng, không tính vào thời gian vòng lặp
+    }
+    logFlush();
+    double seconds = (micros() - otaStart) / 1e6;
+
+    printf("\nOTA %s\n", updater.getState() == OTAUpdater::DONE ? "OK" : updater.getError());
+    printf("  image          %u bytes, downloaded %u bytes (%.1f%%)\n", (unsigned)updater.getImageWritten(),
+           (unsigned)updater.getDownloaded(), 100.0 * updater.getDownloaded() / size);
+    printf("  throughput     %.1f KB/s image, %.1f KB/s network, %.2f s\n",
+           updater.getImageWritten() / 1024.0 / seconds, updater.getDownloaded() / 1024.0 / seconds, seconds);
+    printf("  resumes        %u\n", updater.getResumes());
+    printf("\nLoop iteration time\n");
+    printLoopStats("without OTA", idleLoop);
+    printLoopStats("during OTA", otaLoop);
+    return updater.getState() == OTAUpdater::DONE ? 0 : 2;
+}
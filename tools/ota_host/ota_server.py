@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""HTTP file server có hỗ trợ Range, dùng thay server thật khi test OTA trên host.
+
+Giả lập mạng xấu để test resume:
+  --drop-every N   đóng kết nối sau mỗi N byte gửi đi
+  --rate KBPS      giới hạn tốc độ gửi (KB/s)
+  --no-range       bỏ qua header Range (luôn trả 200), kiểm tra nhánh skip của client
+
+  python3 tools/ota_host/ota_server.py --dir build --port 8000 --drop-every 200000
+"""
+import argparse
+import os
+import re
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ARGS = None
+
+
+class RangeHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        path = os.path.join(ARGS.dir, os.path.basename(self.path.split("?")[0]))
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+        size = os.path.getsize(path)
+
+        start = 0
+        m = re.match(r"bytes=(\d+)-", self.headers.get("Range", ""))
+        if m and not ARGS.no_range:
+            start = int(m.group(1))
+            if start >= size:
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */%d" % size)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            self.send_response(206)
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, size - 1, size))
+        else:
+            self.send_response(200)
+        self.send_header("Content-Length", str(size - start))
+        self.send_header("Connection", "close")
+        self.end_headers()
+
+        sent = 0
+        chunk = 4096
+        t0 = time.time()
+        with open(path, "rb") as f:
+            f.seek(start)
+            while True:
+                data = f.read(chunk)
+                if not data:
+                    break
+                if ARGS.drop_every and sent + len(data) > ARGS.drop_every:
+                    data = data[: ARGS.drop_every - sent]
+                    self.wfile.write(data)
+                    self.log_message("drop connection after %d bytes (offset %d)", ARGS.drop_every, start + ARGS.drop_every)
+                    self.close_connection = True
+                    return
+                self.wfile.write(data)
+                sent += len(data)
+                if ARGS.rate:
+                    ahead = sent / (ARGS.rate * 1024.0) - (time.time() - t0)
+                    if ahead > 0:
+                        time.sleep(ahead)
+
+
+def main():
+    global ARGS
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--dir", default=".")
+    p.add_argument("--port", type=int, default=8000)
+    p.add_argument("--drop-every", type=int, default=0)
+    p.add_argument("--rate", type=float, default=0)
+    p.add_argument("--no-range", action="store_true")
+    ARGS = p.parse_args()
+    server = ThreadingHTTPServer(("0.0.0.0", ARGS.port), RangeHandler)
+    print("Serving %s on :%d" % (os.path.abspath(ARGS.dir), ARGS.port))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()